@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_arena.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_arena_grow(glyph_arena_t* self,
+                 uint32_t min_vertices, uint32_t min_indices)
+{
+	ASSERT(self);
+
+	uint32_t max_vertices = self->max_vertices ?
+	                        self->max_vertices : 4096;
+	while(max_vertices < min_vertices)
+	{
+		max_vertices *= 2;
+	}
+
+	uint32_t max_indices = self->max_indices ?
+	                       self->max_indices : 4096;
+	while(max_indices < min_indices)
+	{
+		max_indices *= 2;
+	}
+
+	if(max_vertices > self->max_vertices)
+	{
+		float* vertices;
+		vertices = (float*)
+		           REALLOC(self->vertices,
+		                   2*max_vertices*sizeof(float));
+		if(vertices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->vertices     = vertices;
+		self->max_vertices = max_vertices;
+	}
+
+	if(max_indices > self->max_indices)
+	{
+		uint16_t* indices;
+		indices = (uint16_t*)
+		          REALLOC(self->indices,
+		                  max_indices*sizeof(uint16_t));
+		if(indices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->indices     = indices;
+		self->max_indices = max_indices;
+	}
+
+	// the GPU buffers are recreated with the new size
+	self->dirty_vertices = 0;
+	self->dirty_indices  = 0;
+
+	++self->grows;
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_arena_t* glyph_arena_new(uint32_t max_vertices,
+                               uint32_t max_indices)
+{
+	glyph_arena_t* self;
+	self = (glyph_arena_t*)
+	       CALLOC(1, sizeof(glyph_arena_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(max_vertices)
+	{
+		self->vertices = (float*)
+		                 MALLOC(2*max_vertices*sizeof(float));
+		if(self->vertices == NULL)
+		{
+			LOGE("MALLOC failed");
+			goto fail_vertices;
+		}
+		self->max_vertices = max_vertices;
+	}
+
+	if(max_indices)
+	{
+		self->indices = (uint16_t*)
+		                MALLOC(max_indices*sizeof(uint16_t));
+		if(self->indices == NULL)
+		{
+			LOGE("MALLOC failed");
+			goto fail_indices;
+		}
+		self->max_indices = max_indices;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_indices:
+		FREE(self->vertices);
+	fail_vertices:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_arena_delete(glyph_arena_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_arena_t* self = *_self;
+	if(self)
+	{
+		// the meshes are owned by the caller
+		if(self->head)
+		{
+			LOGW("meshes=%i", self->allocs - self->frees);
+		}
+
+		FREE(self->indices);
+		FREE(self->vertices);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_arena_alloc(glyph_arena_t* self,
+                      glyph_arenaMesh_t* mesh,
+                      uint32_t vc, uint32_t ic)
+{
+	ASSERT(self);
+	ASSERT(mesh);
+
+	// indices are 16-bit offsets from the first vertex
+	if(vc > GLYPH_ARENA_MAX_MESH_VERTICES)
+	{
+		LOGE("invalid vc=%u", vc);
+		return 0;
+	}
+
+	if((self->top_vertices + vc > self->max_vertices) ||
+	   (self->top_indices  + ic > self->max_indices))
+	{
+		// reclaim the holes and grow the buffers when the
+		// live meshes would fill more than 3/4 of a buffer
+		// so that the compactions are amortized
+		glyph_arena_compact(self);
+
+		uint32_t need_vertices = self->top_vertices + vc;
+		uint32_t need_indices  = self->top_indices  + ic;
+		if(((4*need_vertices > 3*self->max_vertices) ||
+		    (4*need_indices  > 3*self->max_indices)) &&
+		   (glyph_arena_grow(self, 2*need_vertices,
+		                     2*need_indices) == 0))
+		{
+			return 0;
+		}
+	}
+
+	mesh->vb   = self->top_vertices;
+	mesh->vc   = vc;
+	mesh->ib   = self->top_indices;
+	mesh->ic   = ic;
+	mesh->prev = self->tail;
+	mesh->next = NULL;
+
+	if(self->tail)
+	{
+		self->tail->next = mesh;
+	}
+	else
+	{
+		self->head = mesh;
+	}
+	self->tail = mesh;
+
+	self->top_vertices  += vc;
+	self->top_indices   += ic;
+	self->used_vertices += vc;
+	self->used_indices  += ic;
+
+	// the caller writes the new mesh
+	if(mesh->vb < self->dirty_vertices)
+	{
+		self->dirty_vertices = mesh->vb;
+	}
+	if(mesh->ib < self->dirty_indices)
+	{
+		self->dirty_indices = mesh->ib;
+	}
+
+	++self->allocs;
+
+	return 1;
+}
+
+void glyph_arena_free(glyph_arena_t* self,
+                      glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(mesh);
+
+	if(mesh->prev)
+	{
+		mesh->prev->next = mesh->next;
+	}
+	else
+	{
+		self->head = mesh->next;
+	}
+
+	if(mesh->next)
+	{
+		mesh->next->prev = mesh->prev;
+	}
+	else
+	{
+		// freeing the top mesh also frees the hole below
+		self->tail = mesh->prev;
+		if(self->tail)
+		{
+			self->top_vertices = self->tail->vb + self->tail->vc;
+			self->top_indices  = self->tail->ib + self->tail->ic;
+		}
+		else
+		{
+			self->top_vertices = 0;
+			self->top_indices  = 0;
+		}
+	}
+
+	self->used_vertices -= mesh->vc;
+	self->used_indices  -= mesh->ic;
+	++self->frees;
+
+	memset((void*) mesh, 0, sizeof(glyph_arenaMesh_t));
+}
+
+void glyph_arena_compact(glyph_arena_t* self)
+{
+	ASSERT(self);
+
+	if((self->top_vertices == self->used_vertices) &&
+	   (self->top_indices  == self->used_indices))
+	{
+		return;
+	}
+
+	// slide the meshes down in buffer order so the moves
+	// never overlap a mesh which has not been moved
+	uint32_t           vb   = 0;
+	uint32_t           ib   = 0;
+	glyph_arenaMesh_t* mesh = self->head;
+	while(mesh)
+	{
+		if((mesh->vb != vb) || (mesh->ib != ib))
+		{
+			memmove((void*) &self->vertices[2*vb],
+			        (const void*) &self->vertices[2*mesh->vb],
+			        2*mesh->vc*sizeof(float));
+			memmove((void*) &self->indices[ib],
+			        (const void*) &self->indices[mesh->ib],
+			        mesh->ic*sizeof(uint16_t));
+
+			if(vb < self->dirty_vertices)
+			{
+				self->dirty_vertices = vb;
+			}
+			if(ib < self->dirty_indices)
+			{
+				self->dirty_indices = ib;
+			}
+
+			mesh->vb = vb;
+			mesh->ib = ib;
+			++self->moves;
+		}
+
+		vb  += mesh->vc;
+		ib  += mesh->ic;
+		mesh = mesh->next;
+	}
+
+	self->top_vertices = vb;
+	self->top_indices  = ib;
+	++self->compactions;
+}
+
+float* glyph_arena_vertices(glyph_arena_t* self,
+                            glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(mesh);
+
+	return &self->vertices[2*mesh->vb];
+}
+
+uint16_t* glyph_arena_indices(glyph_arena_t* self,
+                              glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(mesh);
+
+	return &self->indices[mesh->ib];
+}
+
+void glyph_arena_clean(glyph_arena_t* self)
+{
+	ASSERT(self);
+
+	self->dirty_vertices = self->top_vertices;
+	self->dirty_indices  = self->top_indices;
+}
+
+void glyph_arena_dump(glyph_arena_t* self)
+{
+	ASSERT(self);
+
+	LOGI("ARENA: vertices=%u/%u/%u, indices=%u/%u/%u",
+	     self->used_vertices, self->top_vertices,
+	     self->max_vertices, self->used_indices,
+	     self->top_indices, self->max_indices);
+	LOGI("ARENA: allocs=%i, frees=%i, grows=%i, compactions=%i, moves=%i",
+	     self->allocs, self->frees, self->grows,
+	     self->compactions, self->moves);
+}
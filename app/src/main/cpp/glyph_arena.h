@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_arena_H
+#define glyph_arena_H
+
+#include <stdint.h>
+
+// The mesh arena suballocates the vertices and indices of
+// glyph meshes from one vertex buffer and one index buffer
+// so that many glyphs may be drawn with a single buffer
+// binding (see glyph_renderer.h) rather than one allocation
+// and binding per glyph. Vertices
+// are (x,y) pairs and the indices of a mesh are relative to
+// its first vertex so meshes may be moved without rewriting
+// their indices.
+//
+// Meshes are appended to the top of the buffers and freed
+// meshes leave holes. The arena is compacted by sliding the
+// meshes down when a mesh does not fit above the top. The
+// buffers are also grown when the live meshes fill more than
+// 3/4 of a buffer so that compaction is amortized.
+// The arena only depends on libcc so it may be used without
+// a GPU. The buffers are a CPU image of the GPU buffers and
+// the dirty offsets are the lowest vertex and index which
+// were modified since the last call to glyph_arena_clean.
+// Growing the buffers resets the dirty offsets to zero
+// since the GPU buffers must be recreated.
+//
+// The mesh structure is owned by the caller and its vertex
+// and index pointers are invalidated by glyph_arena_alloc.
+
+#define GLYPH_ARENA_MAX_MESH_VERTICES 65536
+
+typedef struct glyph_arenaMesh_s
+{
+	// ranges of the arena buffers
+	uint32_t vb;
+	uint32_t vc;
+	uint32_t ib;
+	uint32_t ic;
+
+	// meshes are linked in buffer order
+	struct glyph_arenaMesh_s* prev;
+	struct glyph_arenaMesh_s* next;
+} glyph_arenaMesh_t;
+
+typedef struct glyph_arena_s
+{
+	// vertex buffer of (x,y) pairs
+	uint32_t max_vertices;
+	uint32_t top_vertices;
+	float*   vertices;
+
+	// index buffer
+	uint32_t  max_indices;
+	uint32_t  top_indices;
+	uint16_t* indices;
+
+	// live vertices and indices which exclude the holes
+	uint32_t used_vertices;
+	uint32_t used_indices;
+
+	glyph_arenaMesh_t* head;
+	glyph_arenaMesh_t* tail;
+
+	// lowest modified offsets
+	uint32_t dirty_vertices;
+	uint32_t dirty_indices;
+
+	// statistics
+	int allocs;
+	int frees;
+	int grows;
+	int compactions;
+	int moves;
+} glyph_arena_t;
+
+glyph_arena_t* glyph_arena_new(uint32_t max_vertices,
+                               uint32_t max_indices);
+void           glyph_arena_delete(glyph_arena_t** _self);
+int            glyph_arena_alloc(glyph_arena_t* self,
+                                 glyph_arenaMesh_t* mesh,
+                                 uint32_t vc, uint32_t ic);
+void           glyph_arena_free(glyph_arena_t* self,
+                                glyph_arenaMesh_t* mesh);
+void           glyph_arena_compact(glyph_arena_t* self);
+float*         glyph_arena_vertices(glyph_arena_t* self,
+                                    glyph_arenaMesh_t* mesh);
+uint16_t*      glyph_arena_indices(glyph_arena_t* self,
+                                   glyph_arenaMesh_t* mesh);
+void           glyph_arena_clean(glyph_arena_t* self);
+void           glyph_arena_dump(glyph_arena_t* self);
+
+#endif
@@ -0,0 +1,1182 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph-bench"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "jsmn/wrapper/jsmn_wrapper.h"
+#include "libtess2/Include/tesselator.h"
+#include "glyph_bezier.h"
+#include "glyph_font.h"
+#include "glyph_resource.h"
+
+// each measurement is the best of several runs
+#define GLYPH_BENCH_RUNS 5
+
+// text runs alternate styles per line and are measured
+// against a frame budget
+#define GLYPH_BENCH_STYLES 2
+#define GLYPH_BENCH_LINE   64
+#define GLYPH_BENCH_FRAME  0.016
+
+// relative error of the triangle area of a mesh
+#define GLYPH_BENCH_AREA_TOL 1.0e-4
+
+#define GLYPH_BENCH_FLAGS (GLYPH_OBJECT_FLAG_ANALYTIC | \
+                           GLYPH_OBJECT_FLAG_FORWARD  | \
+                           GLYPH_OBJECT_FLAG_RECURSIVE)
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_bench_parse(const char* str, const char* name,
+                  long min, long max, int* _val)
+{
+	ASSERT(str);
+	ASSERT(name);
+	ASSERT(_val);
+
+	char* end = NULL;
+	long  val = strtol(str, &end, 0);
+	if((end == str) || (*end != '\0') ||
+	   (val < min)  || (val > max))
+	{
+		LOGE("invalid %s=%s", name, str);
+		return 0;
+	}
+
+	*_val = (int) val;
+
+	return 1;
+}
+
+static int
+glyph_bench_synthesize(const char* fname_json,
+                       const char* fname_synth,
+                       int repeat)
+{
+	ASSERT(fname_json);
+	ASSERT(fname_synth);
+
+	// the byte range of each glyph is found by a lazy load
+	glyph_font_t* font;
+	font = glyph_font_newFile(fname_json, GLYPH_FONT_FLAG_LAZY);
+	if(font == NULL)
+	{
+		return 0;
+	}
+
+	FILE* f = fopen(fname_synth, "w");
+	if(f == NULL)
+	{
+		LOGE("fopen %s failed", fname_synth);
+		goto fail_fopen;
+	}
+
+	// the glyphs are repeated under unique names which do
+	// not parse as code points e.g. ascii-0x41-7
+	const char* key  = "\"name\":\"";
+	size_t      klen = strlen(key);
+	int         i;
+	int         r;
+	fprintf(f, "[");
+	for(r = 0; r < repeat; ++r)
+	{
+		for(i = 0; i < glyph_font_count(font); ++i)
+		{
+			glyph_object_t* glyph = &font->glyphs[i];
+			const char*     data  = &font->res->data[glyph->offset];
+			size_t          size  = glyph->size;
+
+			// locate the name value
+			size_t j = 0;
+			while((j + klen <= size) &&
+			      (memcmp(&data[j], key, klen) != 0))
+			{
+				++j;
+			}
+
+			size_t k = j + klen;
+			while((k < size) && (data[k] != '"'))
+			{
+				++k;
+			}
+
+			if(k >= size)
+			{
+				LOGE("invalid name=%s", glyph_object_name(glyph));
+				goto fail_name;
+			}
+
+			fprintf(f, "%s%.*s%s-%i%.*s", (r || i) ? "," : "",
+			        (int) (j + klen), data,
+			        glyph_object_name(glyph), r,
+			        (int) (size - k), &data[k]);
+		}
+	}
+	fprintf(f, "]\n");
+
+	if(fclose(f) != 0)
+	{
+		LOGE("fclose %s failed", fname_synth);
+		goto fail_fclose;
+	}
+
+	glyph_font_delete(&font);
+
+	// success
+	return 1;
+
+	// failure
+	fail_name:
+		fclose(f);
+	fail_fclose:
+	fail_fopen:
+		glyph_font_delete(&font);
+	return 0;
+}
+
+static int
+glyph_bench_same(glyph_font_t* a, glyph_font_t* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	if((a->count      != b->count) ||
+	   (a->np         != b->np)    ||
+	   (a->nc         != b->nc)    ||
+	   (a->size_names != b->size_names))
+	{
+		return 0;
+	}
+
+	size_t np = (size_t) a->np;
+	size_t nc = (size_t) a->nc;
+	if(memcmp(a->x, b->x, np*sizeof(float))   ||
+	   memcmp(a->y, b->y, np*sizeof(float))   ||
+	   memcmp(a->t, b->t, np*sizeof(uint8_t)) ||
+	   memcmp(a->c, b->c, nc*sizeof(int32_t)) ||
+	   memcmp(a->names, b->names, a->size_names))
+	{
+		return 0;
+	}
+
+	int i;
+	for(i = 0; i < a->count; ++i)
+	{
+		glyph_object_t* ga = &a->glyphs[i];
+		glyph_object_t* gb = &b->glyphs[i];
+		if((ga->name != gb->name) || (ga->code != gb->code) ||
+		   (ga->w    != gb->w)    || (ga->h    != gb->h)    ||
+		   (ga->np   != gb->np)   || (ga->p    != gb->p)    ||
+		   (ga->nc   != gb->nc)   || (ga->c    != gb->c))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static double
+glyph_bench_loadTime(const char* fname, int flags,
+                     glyph_font_t* ref)
+{
+	ASSERT(fname);
+
+	double best = 0.0;
+	int    run;
+	for(run = 0; run < GLYPH_BENCH_RUNS; ++run)
+	{
+		double        t0   = cc_timestamp();
+		glyph_font_t* font = glyph_font_newFile(fname, flags);
+		double        dt   = cc_timestamp() - t0;
+		if(font == NULL)
+		{
+			return -1.0;
+		}
+
+		if(ref && (glyph_bench_same(ref, font) == 0))
+		{
+			LOGE("mismatch flags=0x%X", flags);
+			glyph_font_delete(&font);
+			return -1.0;
+		}
+		glyph_font_delete(&font);
+
+		if((run == 0) || (dt < best))
+		{
+			best = dt;
+		}
+	}
+
+	return best;
+}
+
+static int glyph_bench_load(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	int repeat;
+	int threads;
+	if((argc != 6) ||
+	   (glyph_bench_parse(argv[4], "repeat", 1, 100000,
+	                      &repeat) == 0) ||
+	   (glyph_bench_parse(argv[5], "threads", 1, 256,
+	                      &threads) == 0))
+	{
+		LOGE("usage: %s load font.json synth.json repeat threads",
+		     argv[0]);
+		return 0;
+	}
+
+	const char* fname_json  = argv[2];
+	const char* fname_synth = argv[3];
+
+	if(glyph_bench_synthesize(fname_json, fname_synth,
+	                          repeat) == 0)
+	{
+		return 0;
+	}
+
+	// the serial load is the reference for the threaded loads
+	glyph_font_t* ref = glyph_font_newFile(fname_synth, 0);
+	if(ref == NULL)
+	{
+		return 0;
+	}
+
+	printf("font: count=%i, np=%i, nc=%i\n",
+	       ref->count, ref->np, ref->nc);
+
+	double dt = glyph_bench_loadTime(fname_synth, 0, NULL);
+	if(dt < 0.0)
+	{
+		goto fail_load;
+	}
+	printf("serial: %.1f ms\n", 1000.0*dt);
+
+	int t;
+	for(t = 1; t <= threads; ++t)
+	{
+		dt = glyph_bench_loadTime(fname_synth,
+		                          GLYPH_FONT_FLAG_THREADS(t),
+		                          ref);
+		if(dt < 0.0)
+		{
+			goto fail_load;
+		}
+		printf("threads=%i: %.1f ms, same=1\n", t, 1000.0*dt);
+	}
+
+	glyph_font_delete(&ref);
+
+	// success
+	return 1;
+
+	// failure
+	fail_load:
+		glyph_font_delete(&ref);
+	return 0;
+}
+
+static char* glyph_bench_paragraph(int count)
+{
+	const char* sample = "The quick brown fox jumps over the "
+	                     "lazy dog. ";
+	size_t      len    = strlen(sample);
+
+	// the paragraph is wrapped every GLYPH_BENCH_LINE bytes
+	char* str = (char*) MALLOC(2*((size_t) count) + 1);
+	if(str == NULL)
+	{
+		LOGE("MALLOC failed");
+		return NULL;
+	}
+
+	int i;
+	int j = 0;
+	for(i = 0; i < count; ++i)
+	{
+		if(i && ((i % GLYPH_BENCH_LINE) == 0))
+		{
+			str[j++] = '\n';
+		}
+		str[j++] = sample[i % len];
+	}
+	str[j] = '\0';
+
+	return str;
+}
+
+static int
+glyph_bench_record(glyph_font_t* font, const char* str,
+                   glyph_sink_t** sinks, int steps,
+                   int thresh, int flags, int* _glyphs,
+                   glyph_stats_t* stats)
+{
+	ASSERT(font);
+	ASSERT(str);
+	ASSERT(sinks);
+	ASSERT(_glyphs);
+	ASSERT(stats);
+
+	int s;
+	for(s = 0; s < GLYPH_BENCH_STYLES; ++s)
+	{
+		glyph_sink_reset(sinks[s]);
+	}
+
+	// the run is laid out like glyph_text_add and the points
+	// of each style are emitted into one sink which
+	// corresponds to the polygons of a style built by
+	// glyph_text_build
+	float scale  = 32.0f;
+	float pen_x  = 0.0f;
+	float pen_y  = 0.0f;
+	int   style  = 0;
+	int   glyphs = 0;
+	for(; *str; ++str)
+	{
+		if(*str == '\n')
+		{
+			pen_x  = 0.0f;
+			pen_y += scale;
+			style  = (style + 1) % GLYPH_BENCH_STYLES;
+			continue;
+		}
+
+		glyph_object_t* glyph;
+		glyph = glyph_font_lookup(font, (uint8_t) *str);
+		if(glyph == NULL)
+		{
+			continue;
+		}
+
+		if(glyph->np >= 3)
+		{
+			glyph_sink_place(sinks[style], pen_x, pen_y, scale);
+			if(glyph_object_emit(glyph, sinks[style], steps,
+			                     thresh, flags, stats) == 0)
+			{
+				return 0;
+			}
+			++glyphs;
+		}
+
+		pen_x += scale*glyph->w;
+	}
+
+	*_glyphs = glyphs;
+
+	return 1;
+}
+
+static int glyph_bench_text(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	int count;
+	int steps;
+	int thresh;
+	int flags;
+	if((argc != 7) ||
+	   (glyph_bench_parse(argv[3], "count", 1, 10000000,
+	                      &count) == 0)  ||
+	   (glyph_bench_parse(argv[4], "steps", 0,
+	                      GLYPH_OBJECT_MAX_STEPS,
+	                      &steps) == 0)  ||
+	   (glyph_bench_parse(argv[5], "thresh", 0, 1000000,
+	                      &thresh) == 0) ||
+	   (glyph_bench_parse(argv[6], "flags", 0,
+	                      GLYPH_BENCH_FLAGS, &flags) == 0))
+	{
+		LOGE("usage: %s text font.json count steps thresh flags",
+		     argv[0]);
+		return 0;
+	}
+
+	glyph_font_t* font = glyph_font_newFile(argv[2], 0);
+	if(font == NULL)
+	{
+		return 0;
+	}
+
+	char* str = glyph_bench_paragraph(count);
+	if(str == NULL)
+	{
+		goto fail_str;
+	}
+
+	int           s;
+	glyph_sink_t* sinks[GLYPH_BENCH_STYLES] = { NULL };
+	for(s = 0; s < GLYPH_BENCH_STYLES; ++s)
+	{
+		sinks[s] = glyph_sink_new(NULL, NULL);
+		if(sinks[s] == NULL)
+		{
+			goto fail_sink;
+		}
+	}
+
+	// the first run also decomposes the glyph contours
+	double        best   = 0.0;
+	int           glyphs = 0;
+	int           run;
+	glyph_stats_t stats;
+	for(run = 0; run < GLYPH_BENCH_RUNS; ++run)
+	{
+		glyph_stats_reset(&stats);
+
+		double t0 = cc_timestamp();
+		if(glyph_bench_record(font, str, sinks, steps, thresh,
+		                      flags, &glyphs, &stats) == 0)
+		{
+			goto fail_record;
+		}
+
+		double dt = cc_timestamp() - t0;
+		if((run == 0) || (dt < best))
+		{
+			best = dt;
+		}
+	}
+
+	int points = 0;
+	for(s = 0; s < GLYPH_BENCH_STYLES; ++s)
+	{
+		points += sinks[s]->np;
+	}
+
+	printf("text: glyphs=%i, points=%i, styles=%i, dt=%.3f ms\n",
+	       glyphs, points, GLYPH_BENCH_STYLES, 1000.0*best);
+	printf("text: %.0f glyphs per %.0f ms frame\n",
+	       GLYPH_BENCH_FRAME*glyphs/best,
+	       1000.0*GLYPH_BENCH_FRAME);
+
+	// conics per Bezier kernel call
+	float average = 0.0f;
+	if(stats.batches)
+	{
+		average = ((float) stats.batched)/
+		          ((float) stats.batches);
+	}
+	printf("text: kernel=%s, batches=%i, batched=%i, average=%.1f\n",
+	       glyph_bezier_name(), stats.batches, stats.batched,
+	       average);
+
+	for(s = 0; s < GLYPH_BENCH_STYLES; ++s)
+	{
+		glyph_sink_delete(&sinks[s]);
+	}
+	FREE(str);
+	glyph_font_delete(&font);
+
+	// success
+	return 1;
+
+	// failure
+	fail_record:
+	fail_sink:
+		for(s = 0; s < GLYPH_BENCH_STYLES; ++s)
+		{
+			glyph_sink_delete(&sinks[s]);
+		}
+		FREE(str);
+	fail_str:
+		glyph_font_delete(&font);
+	return 0;
+}
+
+static double
+glyph_bench_contourArea(const float* xy, int count)
+{
+	ASSERT(xy);
+
+	double area = 0.0;
+	int    i;
+	int    j = count - 1;
+	for(i = 0; i < count; j = i++)
+	{
+		area += ((double) xy[2*j])*xy[2*i + 1] -
+		        ((double) xy[2*i])*xy[2*j + 1];
+	}
+
+	return 0.5*area;
+}
+
+static int
+glyph_bench_contourInside(const float* xy, int count,
+                          float x, float y)
+{
+	ASSERT(xy);
+
+	// even-odd crossing test
+	int inside = 0;
+	int i;
+	int j = count - 1;
+	for(i = 0; i < count; j = i++)
+	{
+		float xi = xy[2*i];
+		float yi = xy[2*i + 1];
+		float xj = xy[2*j];
+		float yj = xy[2*j + 1];
+		if(((yi > y) != (yj > y)) &&
+		   (x < (xj - xi)*(y - yi)/(yj - yi) + xi))
+		{
+			inside = 1 - inside;
+		}
+	}
+
+	return inside;
+}
+
+static double glyph_bench_outlineArea(glyph_sink_t* sink)
+{
+	ASSERT(sink);
+
+	// the filled area of the even-odd rule adds the contours
+	// at an even nesting depth and subtracts the holes which
+	// is computed independently of the tessellators
+	double area = 0.0;
+	int    i;
+	int    j;
+	for(i = 0; i < sink->nc; ++i)
+	{
+		int first = sink->contours[i];
+		int count = ((i + 1 < sink->nc) ?
+		             sink->contours[i + 1] : sink->np) - first;
+		const float* xy = &sink->xy[2*first];
+
+		int depth = 0;
+		for(j = 0; j < sink->nc; ++j)
+		{
+			int jfirst = sink->contours[j];
+			int jcount = ((j + 1 < sink->nc) ?
+			              sink->contours[j + 1] : sink->np) -
+			             jfirst;
+			if((j != i) &&
+			   glyph_bench_contourInside(&sink->xy[2*jfirst],
+			                             jcount, xy[0], xy[1]))
+			{
+				++depth;
+			}
+		}
+
+		double a = fabs(glyph_bench_contourArea(xy, count));
+		area += (depth % 2) ? -a : a;
+	}
+
+	return area;
+}
+
+static int
+glyph_bench_triangleArea(const float* xy, int nv,
+                         const int* indices, int ni,
+                         double* _area)
+{
+	ASSERT(xy);
+	ASSERT(indices);
+	ASSERT(_area);
+
+	// the triangles must be in range and share an
+	// orientation
+	double area = 0.0;
+	int    pos  = 0;
+	int    neg  = 0;
+	int    i;
+	for(i = 0; i + 2 < ni; i += 3)
+	{
+		int i0 = indices[i];
+		int i1 = indices[i + 1];
+		int i2 = indices[i + 2];
+		if((i0 < 0) || (i0 >= nv) ||
+		   (i1 < 0) || (i1 >= nv) ||
+		   (i2 < 0) || (i2 >= nv))
+		{
+			return 0;
+		}
+
+		const float* p0 = &xy[2*i0];
+		const float* p1 = &xy[2*i1];
+		const float* p2 = &xy[2*i2];
+		double a = ((double) p1[0] - p0[0])*((double) p2[1] - p0[1]) -
+		           ((double) p2[0] - p0[0])*((double) p1[1] - p0[1]);
+		if(a > 0.0)
+		{
+			++pos;
+		}
+		else if(a < 0.0)
+		{
+			++neg;
+		}
+		area += 0.5*fabs(a);
+	}
+
+	*_area = area;
+
+	return (pos == 0) || (neg == 0);
+}
+
+static int
+glyph_bench_libtess2(glyph_sink_t* sink, int count,
+                     double* _dt, double* _area, int* _tris)
+{
+	ASSERT(sink);
+	ASSERT(_dt);
+	ASSERT(_area);
+	ASSERT(_tris);
+
+	// a polygon builder creates a tessellator per build
+	int             i;
+	int             run;
+	int             status = 1;
+	TESStesselator* tess   = NULL;
+	for(run = 0; run < count; ++run)
+	{
+		if(tess)
+		{
+			tessDeleteTess(tess);
+		}
+
+		double t0 = cc_timestamp();
+		tess = tessNewTess(NULL);
+		if(tess == NULL)
+		{
+			LOGE("tessNewTess failed");
+			return 0;
+		}
+
+		for(i = 0; i < sink->nc; ++i)
+		{
+			int first = sink->contours[i];
+			int last  = (i + 1 < sink->nc) ?
+			            sink->contours[i + 1] : sink->np;
+			tessAddContour(tess, 2, &sink->xy[2*first],
+			               2*sizeof(float), last - first);
+		}
+
+		if(tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS,
+		                 3, 2, NULL) == 0)
+		{
+			LOGE("tessTesselate failed");
+			status = 0;
+			break;
+		}
+
+		double dt = cc_timestamp() - t0;
+		if((run == 0) || (dt < *_dt))
+		{
+			*_dt = dt;
+		}
+	}
+
+	if(status)
+	{
+		*_tris = tessGetElementCount(tess);
+		status = glyph_bench_triangleArea(tessGetVertices(tess),
+		                                  tessGetVertexCount(tess),
+		                                  tessGetElements(tess),
+		                                  3*(*_tris), _area);
+	}
+
+	if(tess)
+	{
+		tessDeleteTess(tess);
+	}
+
+	return status;
+}
+
+static int glyph_bench_tess(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	int steps;
+	int thresh;
+	int flags;
+	if((argc != 6) ||
+	   (glyph_bench_parse(argv[3], "steps", 0,
+	                      GLYPH_OBJECT_MAX_STEPS,
+	                      &steps) == 0)  ||
+	   (glyph_bench_parse(argv[4], "thresh", 0, 1000000,
+	                      &thresh) == 0) ||
+	   (glyph_bench_parse(argv[5], "flags", 0,
+	                      GLYPH_BENCH_FLAGS, &flags) == 0))
+	{
+		LOGE("usage: %s tess font.json steps thresh flags",
+		     argv[0]);
+		return 0;
+	}
+
+	glyph_font_t* font = glyph_font_newFile(argv[2], 0);
+	if(font == NULL)
+	{
+		return 0;
+	}
+
+	glyph_sink_t* sink = glyph_sink_new(NULL, NULL);
+	if(sink == NULL)
+	{
+		goto fail_sink;
+	}
+
+	glyph_tess_t* tess = glyph_tess_new();
+	if(tess == NULL)
+	{
+		goto fail_tess;
+	}
+
+	glyph_arena_t* arena = glyph_arena_new(0, 0);
+	if(arena == NULL)
+	{
+		goto fail_arena;
+	}
+
+	int    glyphs     = 0;
+	int    failures   = 0;
+	double points     = 0.0;
+	double tris_glyph = 0.0;
+	double tris_tess2 = 0.0;
+	double dt_glyph   = 0.0;
+	double dt_tess2   = 0.0;
+	double worst      = 0.0;
+	int    i;
+	int    j;
+	for(i = 0; i < glyph_font_count(font); ++i)
+	{
+		glyph_object_t* glyph = glyph_font_glyph(font, i);
+
+		glyph_arenaMesh_t mesh;
+		glyph_stats_t     stats;
+		if(glyph_object_buildMesh(glyph, sink, tess, arena,
+		                          &mesh, steps, thresh, flags,
+		                          &stats) == 0)
+		{
+			continue;
+		}
+
+		// triangulate the points which remain in the sink
+		double dt = 0.0;
+		for(j = 0; j < GLYPH_BENCH_RUNS; ++j)
+		{
+			double t0 = cc_timestamp();
+			if(glyph_tess_triangulate(tess, sink) == 0)
+			{
+				glyph_arena_free(arena, &mesh);
+				goto fail_triangulate;
+			}
+
+			double t1 = cc_timestamp() - t0;
+			if((j == 0) || (t1 < dt))
+			{
+				dt = t1;
+			}
+		}
+
+		// check the mesh against the outline area
+		int*      indices = (int*) MALLOC(mesh.ic*sizeof(int));
+		uint16_t* ib      = glyph_arena_indices(arena, &mesh);
+		if(indices == NULL)
+		{
+			LOGE("MALLOC failed");
+			glyph_arena_free(arena, &mesh);
+			goto fail_triangulate;
+		}
+
+		uint32_t k;
+		for(k = 0; k < mesh.ic; ++k)
+		{
+			indices[k] = ib[k];
+		}
+
+		double area = glyph_bench_outlineArea(sink);
+		double area_glyph;
+		int    valid;
+		valid = glyph_bench_triangleArea(glyph_arena_vertices(arena,
+		                                                      &mesh),
+		                                 (int) mesh.vc, indices,
+		                                 (int) mesh.ic,
+		                                 &area_glyph);
+		FREE(indices);
+
+		double area_tess2 = 0.0;
+		double dt_t2      = 0.0;
+		int    tris       = 0;
+		if(glyph_bench_libtess2(sink, GLYPH_BENCH_RUNS,
+		                        &dt_t2, &area_tess2,
+		                        &tris) == 0)
+		{
+			LOGE("invalid libtess2 mesh %s",
+			     glyph_object_name(glyph));
+			++failures;
+		}
+
+		double err = fabs(area_glyph - area)/fmax(fabs(area),
+		                                          1.0e-12);
+		if((valid == 0) || (err > GLYPH_BENCH_AREA_TOL))
+		{
+			LOGE("invalid mesh %s: area=%lf, mesh=%lf, libtess2=%lf",
+			     glyph_object_name(glyph), area, area_glyph,
+			     area_tess2);
+			++failures;
+		}
+
+		if(err > worst)
+		{
+			worst = err;
+		}
+
+		++glyphs;
+		points     += sink->np;
+		tris_glyph += mesh.ic/3;
+		tris_tess2 += tris;
+		dt_glyph   += dt;
+		dt_tess2   += dt_t2;
+
+		glyph_arena_free(arena, &mesh);
+	}
+
+	if(glyphs)
+	{
+		printf("tess: glyphs=%i, points/glyph=%.1f\n",
+		       glyphs, points/glyphs);
+		printf("glyph_tess: %.2f us/glyph, %.1f tris/glyph\n",
+		       1.0e6*dt_glyph/glyphs, tris_glyph/glyphs);
+		printf("libtess2:   %.2f us/glyph, %.1f tris/glyph\n",
+		       1.0e6*dt_tess2/glyphs, tris_tess2/glyphs);
+		printf("check: failures=%i, worst area error=%.1e\n",
+		       failures, worst);
+	}
+
+	glyph_arena_delete(&arena);
+	glyph_tess_delete(&tess);
+	glyph_sink_delete(&sink);
+	glyph_font_delete(&font);
+
+	return failures == 0;
+
+	// failure
+	fail_triangulate:
+		glyph_arena_delete(&arena);
+	fail_arena:
+		glyph_tess_delete(&tess);
+	fail_tess:
+		glyph_sink_delete(&sink);
+	fail_sink:
+		glyph_font_delete(&font);
+	return 0;
+}
+
+static int
+glyph_bench_domValues(jsmn_val_t* val, int count,
+                      float* f, int* d)
+{
+	ASSERT(val);
+
+	if((val->type != JSMN_TYPE_ARRAY) ||
+	   (cc_list_size(val->array->list) != count))
+	{
+		LOGE("invalid array");
+		return 0;
+	}
+
+	// each value is converted by strtof/strtol like the
+	// jsmn glyph loader
+	int idx = 0;
+	cc_listIter_t* iter = cc_list_head(val->array->list);
+	while(iter)
+	{
+		jsmn_val_t* v = (jsmn_val_t*) cc_list_peekIter(iter);
+		if(v->type != JSMN_TYPE_PRIMITIVE)
+		{
+			LOGE("invalid type=%i", v->type);
+			return 0;
+		}
+
+		if(f)
+		{
+			f[idx] = strtof(v->data, NULL);
+		}
+		else
+		{
+			d[idx] = (int) strtol(v->data, NULL, 0);
+		}
+
+		iter = cc_list_next(iter);
+		++idx;
+	}
+
+	return 1;
+}
+
+static int
+glyph_bench_domGlyph(jsmn_val_t* val, int* _np, int* _nc)
+{
+	ASSERT(val);
+	ASSERT(_np);
+	ASSERT(_nc);
+
+	if(val->type != JSMN_TYPE_OBJECT)
+	{
+		LOGE("invalid type=%i", val->type);
+		return 0;
+	}
+
+	int            np   = 0;
+	int            nc   = 0;
+	jsmn_val_t*    vp   = NULL;
+	jsmn_val_t*    vt   = NULL;
+	jsmn_val_t*    vc   = NULL;
+	cc_listIter_t* iter = cc_list_head(val->obj->list);
+	while(iter)
+	{
+		jsmn_keyval_t* kv;
+		kv = (jsmn_keyval_t*) cc_list_peekIter(iter);
+		if((strcmp(kv->key, "np") == 0) &&
+		   (kv->val->type == JSMN_TYPE_PRIMITIVE))
+		{
+			np = (int) strtol(kv->val->data, NULL, 0);
+		}
+		else if((strcmp(kv->key, "nc") == 0) &&
+		        (kv->val->type == JSMN_TYPE_PRIMITIVE))
+		{
+			nc = (int) strtol(kv->val->data, NULL, 0);
+		}
+		else if(strcmp(kv->key, "p") == 0)
+		{
+			vp = kv->val;
+		}
+		else if(strcmp(kv->key, "t") == 0)
+		{
+			vt = kv->val;
+		}
+		else if(strcmp(kv->key, "c") == 0)
+		{
+			vc = kv->val;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	if((vp == NULL) || (vt == NULL) || (vc == NULL) ||
+	   (np < 0) || (nc < 0))
+	{
+		LOGE("invalid glyph");
+		return 0;
+	}
+
+	// the glyph arrays are allocated per glyph like the
+	// jsmn glyph loader
+	float* p  = (float*) CALLOC(2*np + 1, sizeof(float));
+	int*   t  = (int*)   CALLOC(np + 1, sizeof(int));
+	int*   c  = (int*)   CALLOC(nc + 1, sizeof(int));
+	int    ok = 0;
+	if(p && t && c)
+	{
+		ok = glyph_bench_domValues(vp, 2*np, p, NULL) &&
+		     glyph_bench_domValues(vt, np, NULL, t)   &&
+		     glyph_bench_domValues(vc, nc, NULL, c);
+	}
+	else
+	{
+		LOGE("CALLOC failed");
+	}
+	FREE(p);
+	FREE(t);
+	FREE(c);
+
+	*_np += np;
+	*_nc += nc;
+
+	return ok;
+}
+
+static double
+glyph_bench_domTime(const char* fname, glyph_font_t* ref)
+{
+	ASSERT(fname);
+	ASSERT(ref);
+
+	double best = 0.0;
+	int    run;
+	for(run = 0; run < GLYPH_BENCH_RUNS; ++run)
+	{
+		double t0 = cc_timestamp();
+
+		glyph_resource_t* res = glyph_resource_openFile(fname);
+		if(res == NULL)
+		{
+			return -1.0;
+		}
+
+		jsmn_val_t* root = jsmn_val_new(res->data, res->size);
+		if((root == NULL) || (root->type != JSMN_TYPE_ARRAY))
+		{
+			LOGE("invalid root");
+			jsmn_val_delete(&root);
+			glyph_resource_close(&res);
+			return -1.0;
+		}
+
+		int count = 0;
+		int np    = 0;
+		int nc    = 0;
+		cc_listIter_t* iter = cc_list_head(root->array->list);
+		while(iter)
+		{
+			jsmn_val_t* val = (jsmn_val_t*) cc_list_peekIter(iter);
+			if(glyph_bench_domGlyph(val, &np, &nc) == 0)
+			{
+				jsmn_val_delete(&root);
+				glyph_resource_close(&res);
+				return -1.0;
+			}
+
+			++count;
+			iter = cc_list_next(iter);
+		}
+
+		jsmn_val_delete(&root);
+		glyph_resource_close(&res);
+
+		double dt = cc_timestamp() - t0;
+
+		// both loaders must decode the same outlines
+		if((count != ref->count) || (np != ref->np) ||
+		   (nc != ref->nc))
+		{
+			LOGE("mismatch count=%i/%i, np=%i/%i, nc=%i/%i",
+			     count, ref->count, np, ref->np, nc, ref->nc);
+			return -1.0;
+		}
+
+		if((run == 0) || (dt < best))
+		{
+			best = dt;
+		}
+	}
+
+	return best;
+}
+
+static int glyph_bench_json(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	if(argc != 3)
+	{
+		LOGE("usage: %s json font.json", argv[0]);
+		return 0;
+	}
+
+	const char* fname = argv[2];
+
+	glyph_font_t* ref = glyph_font_newFile(fname, 0);
+	if(ref == NULL)
+	{
+		return 0;
+	}
+
+	printf("font: count=%i, np=%i, nc=%i\n",
+	       ref->count, ref->np, ref->nc);
+
+	double dt_stream = glyph_bench_loadTime(fname, 0, ref);
+	double dt_dom    = glyph_bench_domTime(fname, ref);
+	if((dt_stream < 0.0) || (dt_dom < 0.0))
+	{
+		goto fail_time;
+	}
+
+	printf("jsmn: %.3f ms\n", 1000.0*dt_dom);
+	printf("stream: %.3f ms\n", 1000.0*dt_stream);
+
+	glyph_font_delete(&ref);
+
+	// success
+	return 1;
+
+	// failure
+	fail_time:
+		glyph_font_delete(&ref);
+	return 0;
+}
+
+/***********************************************************
+* main                                                     *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+
+	// load: decode time of a synthetic font which repeats the
+	// glyphs of a font for 1 to N threads (see
+	// GLYPH_FONT_FLAG_THREADS)
+	if((argc >= 2) && (strcmp(argv[1], "load") == 0))
+	{
+		return glyph_bench_load(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// text: headless recording of a text run which emits
+	// the points of each style into one sink
+	if((argc >= 2) && (strcmp(argv[1], "text") == 0))
+	{
+		return glyph_bench_text(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// tess: checks the glyph tessellator against the outline
+	// area and compares it with libtess2
+	if((argc >= 2) && (strcmp(argv[1], "tess") == 0))
+	{
+		return glyph_bench_tess(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// json: load time of the streaming glyph parser
+	// compared with a jsmn DOM of the same font
+	if((argc >= 2) && (strcmp(argv[1], "json") == 0))
+	{
+		return glyph_bench_json(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	LOGE("usage: %s load font.json synth.json repeat threads",
+	     argv[0]);
+	LOGE("usage: %s text font.json count steps thresh flags",
+	     argv[0]);
+	LOGE("usage: %s tess font.json steps thresh flags",
+	     argv[0]);
+	LOGE("usage: %s json font.json", argv[0]);
+	return EXIT_FAILURE;
+}
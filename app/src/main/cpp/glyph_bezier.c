@@ -0,0 +1,835 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#define GLYPH_BEZIER_X86
+	#include <immintrin.h>
+#elif defined(__ARM_NEON)
+	#define GLYPH_BEZIER_NEON
+	#include <arm_neon.h>
+#endif
+
+// disable contraction into fused multiply-add so that every
+// kernel rounds like the scalar kernel
+#if defined(__clang__)
+	#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "glyph_bezier.h"
+
+// request full unrolling of loops with a constant trip count
+#if defined(__clang__)
+	#define GLYPH_BEZIER_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+	#define GLYPH_BEZIER_UNROLL _Pragma("GCC unroll 17")
+#else
+	#define GLYPH_BEZIER_UNROLL
+#endif
+
+typedef void (*glyph_bezier_fn)(int count,
+                                const float* x0,
+                                const float* y0,
+                                const float* x1,
+                                const float* y1,
+                                const float* x2,
+                                const float* y2,
+                                int steps,
+                                float* x, float* y);
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static void
+glyph_bezier_scalar(int count,
+                    const float* x0, const float* y0,
+                    const float* x1, const float* y1,
+                    const float* x2, const float* y2,
+                    int steps, float* x, float* y);
+
+// the scalar kernel is used until a kernel is selected
+static glyph_bezier_fn glyph_bezier_kernel = glyph_bezier_scalar;
+static const char*     glyph_bezier_kernelName = "scalar";
+
+// B(t) = P1 + (1 - t)^2(P0 - P1) + t^2(P2 - P1)
+// The SIMD kernels evaluate the same operations in the same
+// order so results are identical.
+
+// The coefficients (1 - t)^2 and t^2 of t=i/steps are exact
+// for steps=2^k so the tables for k < GLYPH_BEZIER_TABLES
+// match the computed coefficients and every kernel may use
+// them in place of the per-sample divide.
+
+#define GLYPH_BEZIER_TABLES 5
+
+static const float GLYPH_BEZIER_A[GLYPH_BEZIER_TABLES][17] =
+{
+	{
+		1.0f, 0.0f,
+	},
+	{
+		1.0f, 0.25f, 0.0f,
+	},
+	{
+		1.0f, 0.5625f, 0.25f, 0.0625f,
+		0.0f,
+	},
+	{
+		1.0f, 0.765625f, 0.5625f, 0.390625f,
+		0.25f, 0.140625f, 0.0625f, 0.015625f,
+		0.0f,
+	},
+	{
+		1.0f, 0.87890625f, 0.765625f, 0.66015625f,
+		0.5625f, 0.47265625f, 0.390625f, 0.31640625f,
+		0.25f, 0.19140625f, 0.140625f, 0.09765625f,
+		0.0625f, 0.03515625f, 0.015625f, 0.00390625f,
+		0.0f,
+	},
+};
+
+static const float GLYPH_BEZIER_C[GLYPH_BEZIER_TABLES][17] =
+{
+	{
+		0.0f, 1.0f,
+	},
+	{
+		0.0f, 0.25f, 1.0f,
+	},
+	{
+		0.0f, 0.0625f, 0.25f, 0.5625f,
+		1.0f,
+	},
+	{
+		0.0f, 0.015625f, 0.0625f, 0.140625f,
+		0.25f, 0.390625f, 0.5625f, 0.765625f,
+		1.0f,
+	},
+	{
+		0.0f, 0.00390625f, 0.015625f, 0.03515625f,
+		0.0625f, 0.09765625f, 0.140625f, 0.19140625f,
+		0.25f, 0.31640625f, 0.390625f, 0.47265625f,
+		0.5625f, 0.66015625f, 0.765625f, 0.87890625f,
+		1.0f,
+	},
+};
+
+static int glyph_bezier_table(int steps)
+{
+	int k;
+	for(k = 0; k < GLYPH_BEZIER_TABLES; ++k)
+	{
+		if(steps == (1 << k))
+		{
+			return k;
+		}
+	}
+
+	return -1;
+}
+
+static void
+glyph_bezier_sample(float x0, float y0, float x1, float y1,
+                    float x2, float y2, int i, int steps,
+                    float* _x, float* _y)
+{
+	ASSERT(_x);
+	ASSERT(_y);
+
+	float t = ((float) i)/((float) steps);
+	float s = 1.0f - t;
+	float a = s*s;
+	float c = t*t;
+	*_x = x1 + a*(x0 - x1) + c*(x2 - x1);
+	*_y = y1 + a*(y0 - y1) + c*(y2 - y1);
+}
+
+static void
+glyph_bezier_sampleTable(float x0, float y0, float x1, float y1,
+                         float x2, float y2, int i, int k,
+                         float* _x, float* _y)
+{
+	ASSERT(_x);
+	ASSERT(_y);
+
+	float a = GLYPH_BEZIER_A[k][i];
+	float c = GLYPH_BEZIER_C[k][i];
+	*_x = x1 + a*(x0 - x1) + c*(x2 - x1);
+	*_y = y1 + a*(y0 - y1) + c*(y2 - y1);
+}
+
+// the table kernel is specialized for each table by the
+// compiler since k is a constant after inlining
+__attribute__((always_inline))
+static inline void
+glyph_bezier_scalarTable(int count,
+                         const float* x0, const float* y0,
+                         const float* x1, const float* y1,
+                         const float* x2, const float* y2,
+                         const int k, float* x, float* y)
+{
+	const float* a     = GLYPH_BEZIER_A[k];
+	const float* c     = GLYPH_BEZIER_C[k];
+	const int    steps = 1 << k;
+	const int    n     = steps + 1;
+
+	int s;
+	int i;
+	for(s = 0; s < count; ++s)
+	{
+		float  px1 = x1[s];
+		float  py1 = y1[s];
+		float  dx0 = x0[s] - px1;
+		float  dy0 = y0[s] - py1;
+		float  dx2 = x2[s] - px1;
+		float  dy2 = y2[s] - py1;
+		float* xs  = &x[s*n];
+		float* ys  = &y[s*n];
+
+		GLYPH_BEZIER_UNROLL
+		for(i = 0; i < n; ++i)
+		{
+			xs[i] = px1 + a[i]*dx0 + c[i]*dx2;
+			ys[i] = py1 + a[i]*dy0 + c[i]*dy2;
+		}
+	}
+}
+
+static void
+glyph_bezier_scalar(int count,
+                    const float* x0, const float* y0,
+                    const float* x1, const float* y1,
+                    const float* x2, const float* y2,
+                    int steps, float* x, float* y)
+{
+	// specialized kernels for the tables
+	int k = glyph_bezier_table(steps);
+	if(k == 0)
+	{
+		glyph_bezier_scalarTable(count, x0, y0, x1, y1,
+		                         x2, y2, 0, x, y);
+		return;
+	}
+	else if(k == 1)
+	{
+		glyph_bezier_scalarTable(count, x0, y0, x1, y1,
+		                         x2, y2, 1, x, y);
+		return;
+	}
+	else if(k == 2)
+	{
+		glyph_bezier_scalarTable(count, x0, y0, x1, y1,
+		                         x2, y2, 2, x, y);
+		return;
+	}
+	else if(k == 3)
+	{
+		glyph_bezier_scalarTable(count, x0, y0, x1, y1,
+		                         x2, y2, 3, x, y);
+		return;
+	}
+	else if(k == 4)
+	{
+		glyph_bezier_scalarTable(count, x0, y0, x1, y1,
+		                         x2, y2, 4, x, y);
+		return;
+	}
+
+	// generic kernel for arbitrary steps
+	int n = steps + 1;
+	int s;
+	int i;
+	for(s = 0; s < count; ++s)
+	{
+		for(i = 0; i <= steps; ++i)
+		{
+			glyph_bezier_sample(x0[s], y0[s], x1[s], y1[s],
+			                    x2[s], y2[s], i, steps,
+			                    &x[s*n + i], &y[s*n + i]);
+		}
+	}
+}
+
+#ifdef GLYPH_BEZIER_X86
+
+__attribute__((target("sse2")))
+static void
+glyph_bezier_sse(int count,
+                 const float* x0, const float* y0,
+                 const float* x1, const float* y1,
+                 const float* x2, const float* y2,
+                 int steps, float* x, float* y)
+{
+	// short batches of table step counts are faster in the
+	// specialized scalar kernel
+	if((count < 4) && (glyph_bezier_table(steps) >= 0))
+	{
+		glyph_bezier_scalar(count, x0, y0, x1, y1, x2, y2,
+		                    steps, x, y);
+		return;
+	}
+
+	int    n     = steps + 1;
+	int    k     = glyph_bezier_table(steps);
+	__m128 one   = _mm_set1_ps(1.0f);
+	__m128 den   = _mm_set1_ps((float) steps);
+	__m128 lane  = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	int s = 0;
+	int i;
+
+	// lanes hold segments when there are fewer samples per
+	// segment than lanes
+	if(n < 4)
+	{
+		float tx[4];
+		float ty[4];
+		for(; s + 4 <= count; s += 4)
+		{
+			__m128 px1 = _mm_loadu_ps(&x1[s]);
+			__m128 py1 = _mm_loadu_ps(&y1[s]);
+			__m128 dx0 = _mm_sub_ps(_mm_loadu_ps(&x0[s]), px1);
+			__m128 dy0 = _mm_sub_ps(_mm_loadu_ps(&y0[s]), py1);
+			__m128 dx2 = _mm_sub_ps(_mm_loadu_ps(&x2[s]), px1);
+			__m128 dy2 = _mm_sub_ps(_mm_loadu_ps(&y2[s]), py1);
+			for(i = 0; i < n; ++i)
+			{
+				__m128 a;
+				__m128 c;
+				if(k >= 0)
+				{
+					a = _mm_set1_ps(GLYPH_BEZIER_A[k][i]);
+					c = _mm_set1_ps(GLYPH_BEZIER_C[k][i]);
+				}
+				else
+				{
+					__m128 t = _mm_set1_ps(((float) i)/((float) steps));
+					__m128 u = _mm_sub_ps(one, t);
+					a = _mm_mul_ps(u, u);
+					c = _mm_mul_ps(t, t);
+				}
+				__m128 vx = _mm_add_ps(_mm_add_ps(px1, _mm_mul_ps(a, dx0)),
+				                       _mm_mul_ps(c, dx2));
+				__m128 vy = _mm_add_ps(_mm_add_ps(py1, _mm_mul_ps(a, dy0)),
+				                       _mm_mul_ps(c, dy2));
+				_mm_storeu_ps(tx, vx);
+				_mm_storeu_ps(ty, vy);
+				x[s*n + i]       = tx[0];
+				x[(s + 1)*n + i] = tx[1];
+				x[(s + 2)*n + i] = tx[2];
+				x[(s + 3)*n + i] = tx[3];
+				y[s*n + i]       = ty[0];
+				y[(s + 1)*n + i] = ty[1];
+				y[(s + 2)*n + i] = ty[2];
+				y[(s + 3)*n + i] = ty[3];
+			}
+		}
+	}
+
+	for(; s < count; ++s)
+	{
+		__m128 px1 = _mm_set1_ps(x1[s]);
+		__m128 py1 = _mm_set1_ps(y1[s]);
+		__m128 dx0 = _mm_set1_ps(x0[s] - x1[s]);
+		__m128 dy0 = _mm_set1_ps(y0[s] - y1[s]);
+		__m128 dx2 = _mm_set1_ps(x2[s] - x1[s]);
+		__m128 dy2 = _mm_set1_ps(y2[s] - y1[s]);
+		float* xs  = &x[s*n];
+		float* ys  = &y[s*n];
+		for(i = 0; i + 4 <= n; i += 4)
+		{
+			__m128 a;
+			__m128 c;
+			if(k >= 0)
+			{
+				a = _mm_loadu_ps(&GLYPH_BEZIER_A[k][i]);
+				c = _mm_loadu_ps(&GLYPH_BEZIER_C[k][i]);
+			}
+			else
+			{
+				__m128 fi = _mm_add_ps(_mm_set1_ps((float) i), lane);
+				__m128 t  = _mm_div_ps(fi, den);
+				__m128 u  = _mm_sub_ps(one, t);
+				a = _mm_mul_ps(u, u);
+				c = _mm_mul_ps(t, t);
+			}
+			__m128 vx = _mm_add_ps(_mm_add_ps(px1, _mm_mul_ps(a, dx0)),
+			                       _mm_mul_ps(c, dx2));
+			__m128 vy = _mm_add_ps(_mm_add_ps(py1, _mm_mul_ps(a, dy0)),
+			                       _mm_mul_ps(c, dy2));
+			_mm_storeu_ps(&xs[i], vx);
+			_mm_storeu_ps(&ys[i], vy);
+		}
+
+		for(; i < n; ++i)
+		{
+			if(k >= 0)
+			{
+				glyph_bezier_sampleTable(x0[s], y0[s], x1[s], y1[s],
+				                         x2[s], y2[s], i, k,
+				                         &xs[i], &ys[i]);
+			}
+			else
+			{
+				glyph_bezier_sample(x0[s], y0[s], x1[s], y1[s],
+				                    x2[s], y2[s], i, steps,
+				                    &xs[i], &ys[i]);
+			}
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+static void
+glyph_bezier_avx2(int count,
+                  const float* x0, const float* y0,
+                  const float* x1, const float* y1,
+                  const float* x2, const float* y2,
+                  int steps, float* x, float* y)
+{
+	// short batches of table step counts are faster in the
+	// specialized scalar kernel
+	if((count < 8) && (glyph_bezier_table(steps) >= 0))
+	{
+		glyph_bezier_scalar(count, x0, y0, x1, y1, x2, y2,
+		                    steps, x, y);
+		return;
+	}
+
+	int    n    = steps + 1;
+	int    k    = glyph_bezier_table(steps);
+	__m256 one  = _mm256_set1_ps(1.0f);
+	__m256 den  = _mm256_set1_ps((float) steps);
+	__m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f,
+	                             4.0f, 5.0f, 6.0f, 7.0f);
+	int s = 0;
+	int i;
+
+	// lanes hold segments when there are fewer samples per
+	// segment than lanes
+	if(n < 8)
+	{
+		float tx[8];
+		float ty[8];
+		int   j;
+		for(; s + 8 <= count; s += 8)
+		{
+			__m256 px1 = _mm256_loadu_ps(&x1[s]);
+			__m256 py1 = _mm256_loadu_ps(&y1[s]);
+			__m256 dx0 = _mm256_sub_ps(_mm256_loadu_ps(&x0[s]), px1);
+			__m256 dy0 = _mm256_sub_ps(_mm256_loadu_ps(&y0[s]), py1);
+			__m256 dx2 = _mm256_sub_ps(_mm256_loadu_ps(&x2[s]), px1);
+			__m256 dy2 = _mm256_sub_ps(_mm256_loadu_ps(&y2[s]), py1);
+			for(i = 0; i < n; ++i)
+			{
+				__m256 a;
+				__m256 c;
+				if(k >= 0)
+				{
+					a = _mm256_set1_ps(GLYPH_BEZIER_A[k][i]);
+					c = _mm256_set1_ps(GLYPH_BEZIER_C[k][i]);
+				}
+				else
+				{
+					__m256 t = _mm256_set1_ps(((float) i)/((float) steps));
+					__m256 u = _mm256_sub_ps(one, t);
+					a = _mm256_mul_ps(u, u);
+					c = _mm256_mul_ps(t, t);
+				}
+				__m256 vx = _mm256_add_ps(_mm256_add_ps(px1,
+				                                        _mm256_mul_ps(a, dx0)),
+				                          _mm256_mul_ps(c, dx2));
+				__m256 vy = _mm256_add_ps(_mm256_add_ps(py1,
+				                                        _mm256_mul_ps(a, dy0)),
+				                          _mm256_mul_ps(c, dy2));
+				_mm256_storeu_ps(tx, vx);
+				_mm256_storeu_ps(ty, vy);
+				for(j = 0; j < 8; ++j)
+				{
+					x[(s + j)*n + i] = tx[j];
+					y[(s + j)*n + i] = ty[j];
+				}
+			}
+		}
+	}
+
+	for(; s < count; ++s)
+	{
+		__m256 px1 = _mm256_set1_ps(x1[s]);
+		__m256 py1 = _mm256_set1_ps(y1[s]);
+		__m256 dx0 = _mm256_set1_ps(x0[s] - x1[s]);
+		__m256 dy0 = _mm256_set1_ps(y0[s] - y1[s]);
+		__m256 dx2 = _mm256_set1_ps(x2[s] - x1[s]);
+		__m256 dy2 = _mm256_set1_ps(y2[s] - y1[s]);
+		float* xs  = &x[s*n];
+		float* ys  = &y[s*n];
+		for(i = 0; i + 8 <= n; i += 8)
+		{
+			__m256 a;
+			__m256 c;
+			if(k >= 0)
+			{
+				a = _mm256_loadu_ps(&GLYPH_BEZIER_A[k][i]);
+				c = _mm256_loadu_ps(&GLYPH_BEZIER_C[k][i]);
+			}
+			else
+			{
+				__m256 fi = _mm256_add_ps(_mm256_set1_ps((float) i),
+				                          lane);
+				__m256 t  = _mm256_div_ps(fi, den);
+				__m256 u  = _mm256_sub_ps(one, t);
+				a = _mm256_mul_ps(u, u);
+				c = _mm256_mul_ps(t, t);
+			}
+			__m256 vx = _mm256_add_ps(_mm256_add_ps(px1,
+			                                        _mm256_mul_ps(a, dx0)),
+			                          _mm256_mul_ps(c, dx2));
+			__m256 vy = _mm256_add_ps(_mm256_add_ps(py1,
+			                                        _mm256_mul_ps(a, dy0)),
+			                          _mm256_mul_ps(c, dy2));
+			_mm256_storeu_ps(&xs[i], vx);
+			_mm256_storeu_ps(&ys[i], vy);
+		}
+
+		for(; i < n; ++i)
+		{
+			if(k >= 0)
+			{
+				glyph_bezier_sampleTable(x0[s], y0[s], x1[s], y1[s],
+				                         x2[s], y2[s], i, k,
+				                         &xs[i], &ys[i]);
+			}
+			else
+			{
+				glyph_bezier_sample(x0[s], y0[s], x1[s], y1[s],
+				                    x2[s], y2[s], i, steps,
+				                    &xs[i], &ys[i]);
+			}
+		}
+	}
+}
+
+#endif
+
+#ifdef GLYPH_BEZIER_NEON
+
+static void
+glyph_bezier_neon(int count,
+                  const float* x0, const float* y0,
+                  const float* x1, const float* y1,
+                  const float* x2, const float* y2,
+                  int steps, float* x, float* y)
+{
+	// short batches of table step counts are faster in the
+	// specialized scalar kernel
+	if((count < 4) && (glyph_bezier_table(steps) >= 0))
+	{
+		glyph_bezier_scalar(count, x0, y0, x1, y1, x2, y2,
+		                    steps, x, y);
+		return;
+	}
+
+	int         n   = steps + 1;
+	int         k   = glyph_bezier_table(steps);
+	float32x4_t one = vdupq_n_f32(1.0f);
+	#ifdef __aarch64__
+	float       lf[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+	float32x4_t lane  = vld1q_f32(lf);
+	float32x4_t den   = vdupq_n_f32((float) steps);
+	#endif
+	int s;
+	int i;
+	for(s = 0; s < count; ++s)
+	{
+		float32x4_t px1 = vdupq_n_f32(x1[s]);
+		float32x4_t py1 = vdupq_n_f32(y1[s]);
+		float32x4_t dx0 = vdupq_n_f32(x0[s] - x1[s]);
+		float32x4_t dy0 = vdupq_n_f32(y0[s] - y1[s]);
+		float32x4_t dx2 = vdupq_n_f32(x2[s] - x1[s]);
+		float32x4_t dy2 = vdupq_n_f32(y2[s] - y1[s]);
+		float*      xs  = &x[s*n];
+		float*      ys  = &y[s*n];
+		for(i = 0; i + 4 <= n; i += 4)
+		{
+			float32x4_t a;
+			float32x4_t c;
+			if(k >= 0)
+			{
+				a = vld1q_f32(&GLYPH_BEZIER_A[k][i]);
+				c = vld1q_f32(&GLYPH_BEZIER_C[k][i]);
+			}
+			else
+			{
+				#ifdef __aarch64__
+				float32x4_t fi = vaddq_f32(vdupq_n_f32((float) i), lane);
+				float32x4_t t  = vdivq_f32(fi, den);
+				#else
+				// ARMv7 NEON lacks a vector divide so the lanes
+				// are divided individually to match the scalar
+				// kernel
+				float tf[4] =
+				{
+					((float) (i + 0))/((float) steps),
+					((float) (i + 1))/((float) steps),
+					((float) (i + 2))/((float) steps),
+					((float) (i + 3))/((float) steps),
+				};
+				float32x4_t t = vld1q_f32(tf);
+				#endif
+				float32x4_t u = vsubq_f32(one, t);
+				a = vmulq_f32(u, u);
+				c = vmulq_f32(t, t);
+			}
+			float32x4_t vx = vaddq_f32(vaddq_f32(px1, vmulq_f32(a, dx0)),
+			                           vmulq_f32(c, dx2));
+			float32x4_t vy = vaddq_f32(vaddq_f32(py1, vmulq_f32(a, dy0)),
+			                           vmulq_f32(c, dy2));
+			vst1q_f32(&xs[i], vx);
+			vst1q_f32(&ys[i], vy);
+		}
+
+		for(; i < n; ++i)
+		{
+			if(k >= 0)
+			{
+				glyph_bezier_sampleTable(x0[s], y0[s], x1[s], y1[s],
+				                         x2[s], y2[s], i, k,
+				                         &xs[i], &ys[i]);
+			}
+			else
+			{
+				glyph_bezier_sample(x0[s], y0[s], x1[s], y1[s],
+				                    x2[s], y2[s], i, steps,
+				                    &xs[i], &ys[i]);
+			}
+		}
+	}
+}
+
+#endif
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int glyph_bezier_select(int kernel)
+{
+	if(kernel == GLYPH_BEZIER_KERNEL_AUTO)
+	{
+		#if defined(GLYPH_BEZIER_X86)
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2"))
+		{
+			kernel = GLYPH_BEZIER_KERNEL_AVX2;
+		}
+		else if(__builtin_cpu_supports("sse2"))
+		{
+			kernel = GLYPH_BEZIER_KERNEL_SSE;
+		}
+		else
+		{
+			kernel = GLYPH_BEZIER_KERNEL_SCALAR;
+		}
+		#elif defined(GLYPH_BEZIER_NEON)
+		kernel = GLYPH_BEZIER_KERNEL_NEON;
+		#else
+		kernel = GLYPH_BEZIER_KERNEL_SCALAR;
+		#endif
+	}
+
+	if(kernel == GLYPH_BEZIER_KERNEL_SCALAR)
+	{
+		glyph_bezier_kernel     = glyph_bezier_scalar;
+		glyph_bezier_kernelName = "scalar";
+		return 1;
+	}
+	#if defined(GLYPH_BEZIER_X86)
+	else if((kernel == GLYPH_BEZIER_KERNEL_SSE) &&
+	        __builtin_cpu_supports("sse2"))
+	{
+		glyph_bezier_kernel     = glyph_bezier_sse;
+		glyph_bezier_kernelName = "sse";
+		return 1;
+	}
+	else if((kernel == GLYPH_BEZIER_KERNEL_AVX2) &&
+	        __builtin_cpu_supports("avx2"))
+	{
+		glyph_bezier_kernel     = glyph_bezier_avx2;
+		glyph_bezier_kernelName = "avx2";
+		return 1;
+	}
+	#elif defined(GLYPH_BEZIER_NEON)
+	else if(kernel == GLYPH_BEZIER_KERNEL_NEON)
+	{
+		glyph_bezier_kernel     = glyph_bezier_neon;
+		glyph_bezier_kernelName = "neon";
+		return 1;
+	}
+	#endif
+
+	LOGE("unsupported kernel=%i", kernel);
+	return 0;
+}
+
+const char* glyph_bezier_name(void)
+{
+	return glyph_bezier_kernelName;
+}
+
+void glyph_bezier_evaluate(int count,
+                           const float* x0, const float* y0,
+                           const float* x1, const float* y1,
+                           const float* x2, const float* y2,
+                           int steps, float* x, float* y)
+{
+	ASSERT(x0);
+	ASSERT(y0);
+	ASSERT(x1);
+	ASSERT(y1);
+	ASSERT(x2);
+	ASSERT(y2);
+	ASSERT(steps > 0);
+	ASSERT(x);
+	ASSERT(y);
+
+	glyph_bezier_kernel(count, x0, y0, x1, y1, x2, y2,
+	                    steps, x, y);
+}
+
+void glyph_bezier_forward(float x0, float y0,
+                          float x1, float y1,
+                          float x2, float y2,
+                          int steps, float* x, float* y)
+{
+	ASSERT(steps > 0);
+	ASSERT(x);
+	ASSERT(y);
+
+	// B(t)   = P0 + 2t(P1 - P0) + t^2(P0 - 2P1 + P2)
+	// dB(t)  = B(t + h) - B(t) = 2h(P1 - P0) + (2t + h)h*A
+	// ddB(t) = 2h^2*A
+	float h   = 1.0f/((float) steps);
+	float ax  = x0 - 2.0f*x1 + x2;
+	float ay  = y0 - 2.0f*y1 + y2;
+	float dx  = 2.0f*h*(x1 - x0) + h*h*ax;
+	float dy  = 2.0f*h*(y1 - y0) + h*h*ay;
+	float ddx = 2.0f*h*h*ax;
+	float ddy = 2.0f*h*h*ay;
+	float px  = x0;
+	float py  = y0;
+
+	int i;
+	for(i = 0; i < steps - 1; ++i)
+	{
+		px  += dx;
+		py  += dy;
+		dx  += ddx;
+		dy  += ddy;
+		x[i] = px;
+		y[i] = py;
+	}
+
+	// avoid drift at the end point
+	x[steps - 1] = x2;
+	y[steps - 1] = y2;
+}
+
+void glyph_bezier_evaluateCubic(float x0, float y0,
+                                float x1, float y1,
+                                float x2, float y2,
+                                float x3, float y3,
+                                int steps, float* x, float* y)
+{
+	ASSERT(steps > 0);
+	ASSERT(x);
+	ASSERT(y);
+
+	// B(t) = s^3*P0 + 3s^2t*P1 + 3st^2*P2 + t^3*P3
+	int i;
+	for(i = 0; i <= steps; ++i)
+	{
+		float t = ((float) i)/((float) steps);
+		float s = 1.0f - t;
+		float a = s*s*s;
+		float b = 3.0f*s*s*t;
+		float c = 3.0f*s*t*t;
+		float d = t*t*t;
+		x[i] = a*x0 + b*x1 + c*x2 + d*x3;
+		y[i] = a*y0 + b*y1 + c*y2 + d*y3;
+	}
+}
+
+void glyph_bezier_forwardCubic(float x0, float y0,
+                               float x1, float y1,
+                               float x2, float y2,
+                               float x3, float y3,
+                               int steps, float* x, float* y)
+{
+	ASSERT(steps > 0);
+	ASSERT(x);
+	ASSERT(y);
+
+	// B(t)    = P0 + t*C1 + t^2*C2 + t^3*C3
+	// dB(0)   = h*C1 + h^2*C2 + h^3*C3
+	// ddB(0)  = 2h^2*C2 + 6h^3*C3
+	// dddB(t) = 6h^3*C3
+	float h    = 1.0f/((float) steps);
+	float h2   = h*h;
+	float h3   = h2*h;
+	float c1x  = 3.0f*(x1 - x0);
+	float c1y  = 3.0f*(y1 - y0);
+	float c2x  = 3.0f*(x0 - 2.0f*x1 + x2);
+	float c2y  = 3.0f*(y0 - 2.0f*y1 + y2);
+	float c3x  = x3 - x0 + 3.0f*(x1 - x2);
+	float c3y  = y3 - y0 + 3.0f*(y1 - y2);
+	float dx   = h*c1x + h2*c2x + h3*c3x;
+	float dy   = h*c1y + h2*c2y + h3*c3y;
+	float ddx  = 2.0f*h2*c2x + 6.0f*h3*c3x;
+	float ddy  = 2.0f*h2*c2y + 6.0f*h3*c3y;
+	float dddx = 6.0f*h3*c3x;
+	float dddy = 6.0f*h3*c3y;
+	float px   = x0;
+	float py   = y0;
+
+	int i;
+	for(i = 0; i < steps - 1; ++i)
+	{
+		px  += dx;
+		py  += dy;
+		dx  += ddx;
+		dy  += ddy;
+		ddx += dddx;
+		ddy += dddy;
+		x[i] = px;
+		y[i] = py;
+	}
+
+	// avoid drift at the end point
+	x[steps - 1] = x3;
+	y[steps - 1] = y3;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_bezier_H
+#define glyph_bezier_H
+
+// The bezier kernel evaluates batches of quadratic Bezier
+// segments stored in SoA form. Each segment is sampled at
+// t=i/steps for i=0..steps and the samples are stored
+// contiguously per segment (e.g. x[s*(steps + 1) + i]).
+// The kernel is selected at runtime and every kernel
+// produces results identical to the scalar kernel. The
+// scalar kernel is used until glyph_bezier_select is called
+// which must not race with glyph_bezier_evaluate so the
+// kernel is selected before any build threads are started
+// (e.g. glyph_pool_new).
+// Power of two steps (1, 2, 4, 8 and 16) use unrolled kernels
+// with precomputed coefficient tables and other steps use a
+// generic loop.
+//
+// The forward differencing emitter writes the samples for
+// i=1..steps of a single segment using two adds per point.
+// Rounding accumulates with each step so the samples differ
+// from glyph_bezier_evaluate by up to GLYPH_BEZIER_FORWARD_TOL
+// for segments with coordinates in [0,1] and steps <= 16.
+// The final sample is exactly P2.
+//
+// Cubic Bezier segments are evaluated one segment at a time
+// by the scalar kernel since they only occur in CFF outlines.
+// The cubic forward differencing emitter uses three adds per
+// point and differs by up to GLYPH_BEZIER_FORWARD_CUBIC_TOL.
+
+#define GLYPH_BEZIER_FORWARD_TOL       1.0e-6f
+#define GLYPH_BEZIER_FORWARD_CUBIC_TOL 2.0e-6f
+
+#define GLYPH_BEZIER_KERNEL_AUTO   0
+#define GLYPH_BEZIER_KERNEL_SCALAR 1
+#define GLYPH_BEZIER_KERNEL_SSE    2
+#define GLYPH_BEZIER_KERNEL_AVX2   3
+#define GLYPH_BEZIER_KERNEL_NEON   4
+
+int         glyph_bezier_select(int kernel);
+const char* glyph_bezier_name(void);
+void        glyph_bezier_evaluate(int count,
+                                  const float* x0,
+                                  const float* y0,
+                                  const float* x1,
+                                  const float* y1,
+                                  const float* x2,
+                                  const float* y2,
+                                  int steps,
+                                  float* x, float* y);
+void        glyph_bezier_forward(float x0, float y0,
+                                 float x1, float y1,
+                                 float x2, float y2,
+                                 int steps,
+                                 float* x, float* y);
+void        glyph_bezier_evaluateCubic(float x0, float y0,
+                                       float x1, float y1,
+                                       float x2, float y2,
+                                       float x3, float y3,
+                                       int steps,
+                                       float* x, float* y);
+void        glyph_bezier_forwardCubic(float x0, float y0,
+                                      float x1, float y1,
+                                      float x2, float y2,
+                                      float x3, float y3,
+                                      int steps,
+                                      float* x, float* y);
+
+#endif
@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_cache.h"
+
+#define GLYPH_CACHE_BITS 8
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// polygons are shared by entries which emit the same points
+typedef struct
+{
+	vkk_vgPolygon_t* poly;
+	size_t           size;
+	int              refcount;
+} glyph_cachePolygon_t;
+
+typedef struct glyph_cacheEntry_s
+{
+	glyph_object_t* glyph;
+	int             steps;
+	int             thresh;
+	int             flags;
+
+	glyph_cachePolygon_t* polygon;
+
+	// LRU list
+	struct glyph_cacheEntry_s* prev;
+	struct glyph_cacheEntry_s* next;
+
+	// hash bucket
+	struct glyph_cacheEntry_s* chain;
+} glyph_cacheEntry_t;
+
+static size_t glyph_cache_estimate(int points)
+{
+	// a polygon of n points has about n vertices (two
+	// floats) and n triangles (three uint16_t indices)
+	size_t vb = 2*sizeof(float);
+	size_t ib = 3*sizeof(uint16_t);
+	return 256 + 2*((size_t) points)*(vb + ib);
+}
+
+static int
+glyph_cache_match(glyph_cacheEntry_t* entry,
+                  glyph_object_t* glyph,
+                  int steps, int thresh, int flags)
+{
+	ASSERT(entry);
+
+	return (entry->glyph  == glyph)  &&
+	       (entry->steps  == steps)  &&
+	       (entry->thresh == thresh) &&
+	       (entry->flags  == flags);
+}
+
+static glyph_cacheEntry_t**
+glyph_cache_bucket(glyph_cache_t* self,
+                   glyph_object_t* glyph)
+{
+	ASSERT(self);
+
+	// Fibonacci hashing of the glyph address
+	uint64_t h = (uint64_t) ((uintptr_t) glyph);
+	h *= 0x9E3779B97F4A7C15ULL;
+	return &self->buckets[h >> (64 - self->bits)];
+}
+
+static void
+glyph_cache_attach(glyph_cache_t* self,
+                   glyph_cacheEntry_t* entry)
+{
+	ASSERT(self);
+	ASSERT(entry);
+
+	glyph_cacheEntry_t** _bucket;
+	_bucket = glyph_cache_bucket(self, entry->glyph);
+
+	entry->chain = *_bucket;
+	*_bucket     = entry;
+}
+
+static void
+glyph_cache_detach(glyph_cache_t* self,
+                   glyph_cacheEntry_t* entry)
+{
+	ASSERT(self);
+	ASSERT(entry);
+
+	glyph_cacheEntry_t** _iter;
+	_iter = glyph_cache_bucket(self, entry->glyph);
+	while(*_iter)
+	{
+		if(*_iter == entry)
+		{
+			*_iter       = entry->chain;
+			entry->chain = NULL;
+			return;
+		}
+		_iter = &(*_iter)->chain;
+	}
+}
+
+static int
+glyph_cache_resize(glyph_cache_t* self, int bits)
+{
+	ASSERT(self);
+
+	glyph_cacheEntry_t** buckets;
+	buckets = (glyph_cacheEntry_t**)
+	          CALLOC(((size_t) 1) << bits,
+	                 sizeof(glyph_cacheEntry_t*));
+	if(buckets == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	FREE(self->buckets);
+	self->buckets = buckets;
+	self->bits    = bits;
+
+	// attach the entries from the least recently used so
+	// that each bucket is ordered from the most recently used
+	glyph_cacheEntry_t* entry = self->tail;
+	while(entry)
+	{
+		glyph_cache_attach(self, entry);
+		entry = entry->prev;
+	}
+
+	return 1;
+}
+
+static void
+glyph_cache_unlink(glyph_cache_t* self,
+                   glyph_cacheEntry_t* entry)
+{
+	ASSERT(self);
+	ASSERT(entry);
+
+	if(entry->prev)
+	{
+		entry->prev->next = entry->next;
+	}
+	else
+	{
+		self->head = entry->next;
+	}
+
+	if(entry->next)
+	{
+		entry->next->prev = entry->prev;
+	}
+	else
+	{
+		self->tail = entry->prev;
+	}
+
+	entry->prev = NULL;
+	entry->next = NULL;
+}
+
+static void
+glyph_cache_push(glyph_cache_t* self,
+                 glyph_cacheEntry_t* entry)
+{
+	ASSERT(self);
+	ASSERT(entry);
+
+	entry->prev = NULL;
+	entry->next = self->head;
+	if(self->head)
+	{
+		self->head->prev = entry;
+	}
+	else
+	{
+		self->tail = entry;
+	}
+	self->head = entry;
+}
+
+static void
+glyph_cache_release(glyph_cache_t* self,
+                    glyph_cachePolygon_t** _polygon)
+{
+	ASSERT(self);
+	ASSERT(_polygon);
+
+	glyph_cachePolygon_t* polygon = *_polygon;
+	if(polygon)
+	{
+		polygon->refcount -= 1;
+		if(polygon->refcount <= 0)
+		{
+			self->size -= polygon->size;
+			vkk_vgPolygon_delete(&polygon->poly);
+			FREE(polygon);
+		}
+		*_polygon = NULL;
+	}
+}
+
+static void
+glyph_cache_evict(glyph_cache_t* self,
+                  glyph_cacheEntry_t* entry)
+{
+	ASSERT(self);
+	ASSERT(entry);
+
+	glyph_cache_detach(self, entry);
+	glyph_cache_unlink(self, entry);
+	glyph_cache_release(self, &entry->polygon);
+	FREE(entry);
+	self->count -= 1;
+}
+
+static glyph_cacheEntry_t*
+glyph_cache_lookup(glyph_cache_t* self,
+                   glyph_object_t* glyph,
+                   int steps, int thresh, int flags,
+                   int touch)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	glyph_cacheEntry_t** _bucket;
+	_bucket = glyph_cache_bucket(self, glyph);
+
+	glyph_cacheEntry_t** _iter = _bucket;
+	while(*_iter)
+	{
+		glyph_cacheEntry_t* entry = *_iter;
+		if(glyph_cache_match(entry, glyph, steps,
+		                     thresh, flags))
+		{
+			// move the entry to the front of the bucket
+			// and the LRU list
+			if(touch)
+			{
+				*_iter       = entry->chain;
+				entry->chain = *_bucket;
+				*_bucket     = entry;
+
+				glyph_cache_unlink(self, entry);
+				glyph_cache_push(self, entry);
+			}
+
+			return entry;
+		}
+		_iter = &entry->chain;
+	}
+
+	return NULL;
+}
+
+static int
+glyph_cache_add(glyph_cache_t* self,
+                glyph_object_t* glyph,
+                int steps, int thresh, int flags,
+                glyph_cachePolygon_t* polygon)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(polygon);
+
+	// an entry may only be added once
+	if(glyph_cache_lookup(self, glyph, steps, thresh,
+	                      flags, 0))
+	{
+		LOGW("duplicate glyph=%s, steps=%i, thresh=%i, flags=%i",
+		     glyph_object_name(glyph), steps, thresh, flags);
+		return 0;
+	}
+
+	// grow the hash table to one entry per bucket where a
+	// failure only affects the performance
+	if(self->count >= (1 << self->bits))
+	{
+		glyph_cache_resize(self, self->bits + 1);
+	}
+
+	glyph_cacheEntry_t* entry;
+	entry = (glyph_cacheEntry_t*)
+	        CALLOC(1, sizeof(glyph_cacheEntry_t));
+	if(entry == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	entry->glyph   = glyph;
+	entry->steps   = steps;
+	entry->thresh  = thresh;
+	entry->flags   = flags;
+	entry->polygon = polygon;
+
+	polygon->refcount += 1;
+	glyph_cache_push(self, entry);
+	glyph_cache_attach(self, entry);
+	self->count += 1;
+
+	return 1;
+}
+
+static void glyph_cache_trim(glyph_cache_t* self)
+{
+	ASSERT(self);
+
+	// the most recently used entry is never evicted since
+	// it is returned to the caller
+	while((self->size > self->budget) &&
+	      self->tail && (self->tail != self->head))
+	{
+		glyph_cache_evict(self, self->tail);
+		self->evictions += 1;
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_cache_t* glyph_cache_new(size_t budget)
+{
+	glyph_cache_t* self;
+	self = (glyph_cache_t*)
+	       CALLOC(1, sizeof(glyph_cache_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->budget = budget;
+
+	if(glyph_cache_resize(self, GLYPH_CACHE_BITS) == 0)
+	{
+		goto fail_buckets;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_buckets:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_cache_delete(glyph_cache_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_cache_t* self = *_self;
+	if(self)
+	{
+		while(self->head)
+		{
+			glyph_cache_evict(self, self->head);
+		}
+
+		FREE(self->buckets);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+vkk_vgPolygon_t*
+glyph_cache_find(glyph_cache_t* self,
+                 glyph_object_t* glyph,
+                 int steps, int thresh, int flags)
+{
+	ASSERT(self);
+
+	glyph_cacheEntry_t* entry;
+	entry = glyph_cache_lookup(self, glyph, steps, thresh,
+	                           flags, 1);
+	if(entry == NULL)
+	{
+		return NULL;
+	}
+
+	self->hits += 1;
+
+	return entry->polygon->poly;
+}
+
+vkk_vgPolygon_t*
+glyph_cache_peek(glyph_cache_t* self,
+                 glyph_object_t* glyph,
+                 int steps, int thresh, int flags)
+{
+	ASSERT(self);
+
+	glyph_cacheEntry_t* entry;
+	entry = glyph_cache_lookup(self, glyph, steps, thresh,
+	                           flags, 0);
+	if(entry == NULL)
+	{
+		return NULL;
+	}
+
+	return entry->polygon->poly;
+}
+
+vkk_vgPolygon_t*
+glyph_cache_share(glyph_cache_t* self,
+                  glyph_object_t* glyph,
+                  int steps, int thresh, int flags,
+                  glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	// find the most recently used entry of the glyph which
+	// is the first entry of the glyph in its bucket
+	glyph_cacheEntry_t* entry = *glyph_cache_bucket(self, glyph);
+	while(entry && (entry->glyph != glyph))
+	{
+		entry = entry->chain;
+	}
+
+	if((entry == NULL) ||
+	   (glyph_object_samePoints(glyph, entry->steps,
+	                            entry->thresh, entry->flags,
+	                            steps, thresh, flags) == 0))
+	{
+		return NULL;
+	}
+
+	// the polygon is referenced while it is added
+	glyph_cachePolygon_t* polygon = entry->polygon;
+	polygon->refcount += 1;
+
+	vkk_vgPolygon_t* poly = polygon->poly;
+	if(glyph_cache_add(self, glyph, steps, thresh,
+	                   flags, polygon) == 0)
+	{
+		poly = NULL;
+	}
+	glyph_cache_release(self, &polygon);
+
+	if(poly)
+	{
+		self->shares += 1;
+		if(stats)
+		{
+			stats->skips += 1;
+		}
+	}
+
+	return poly;
+}
+
+int glyph_cache_insert(glyph_cache_t* self,
+                       glyph_object_t* glyph,
+                       int steps, int thresh, int flags,
+                       vkk_vgPolygon_t* poly, int points)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(poly);
+
+	glyph_cachePolygon_t* polygon;
+	polygon = (glyph_cachePolygon_t*)
+	          CALLOC(1, sizeof(glyph_cachePolygon_t));
+	if(polygon == NULL)
+	{
+		LOGE("CALLOC failed");
+		vkk_vgPolygon_delete(&poly);
+		return 0;
+	}
+
+	// the polygon is referenced while it is added
+	polygon->poly     = poly;
+	polygon->size     = glyph_cache_estimate(points);
+	polygon->refcount = 1;
+	self->size       += polygon->size;
+
+	int status = glyph_cache_add(self, glyph, steps, thresh,
+	                             flags, polygon);
+	glyph_cache_release(self, &polygon);
+
+	if(status)
+	{
+		self->misses += 1;
+		glyph_cache_trim(self);
+	}
+
+	return status;
+}
+
+vkk_vgPolygon_t*
+glyph_cache_build(glyph_cache_t* self,
+                  glyph_object_t* glyph,
+                  vkk_vgPolygonBuilder_t* pb,
+                  int steps,
+                  int thresh,
+                  int flags,
+                  glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(pb);
+
+	if(steps > GLYPH_OBJECT_MAX_STEPS)
+	{
+		LOGW("invalid steps=%i", steps);
+		steps = GLYPH_OBJECT_MAX_STEPS;
+	}
+
+	vkk_vgPolygon_t* poly;
+	poly = glyph_cache_find(self, glyph, steps, thresh, flags);
+	if(poly)
+	{
+		return poly;
+	}
+
+	poly = glyph_cache_share(self, glyph, steps, thresh, flags,
+	                         stats);
+	if(poly)
+	{
+		return poly;
+	}
+
+	poly = glyph_polygon_build(glyph, pb, steps, thresh,
+	                           flags, &glyph->stats);
+	if(stats)
+	{
+		glyph_stats_add(stats, &glyph->stats);
+	}
+
+	if((poly == NULL) ||
+	   (glyph_cache_insert(self, glyph, steps, thresh, flags,
+	                       poly, glyph->stats.points) == 0))
+	{
+		return NULL;
+	}
+
+	return poly;
+}
+
+void glyph_cache_dump(glyph_cache_t* self)
+{
+	ASSERT(self);
+
+	LOGI("CACHE: entries=%i, size=%i, budget=%i",
+	     self->count, (int) self->size,
+	     (int) self->budget);
+	LOGI("CACHE: hits=%i, misses=%i, shares=%i, evictions=%i",
+	     self->hits, self->misses, self->shares,
+	     self->evictions);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_cache_H
+#define glyph_cache_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libvkk/vkk_vg.h"
+#include "glyph_object.h"
+#include "glyph_polygon.h"
+#include "glyph_stats.h"
+
+// The polygon cache holds the polygons built by the engine
+// keyed by the glyph and the build parameters (steps, thresh
+// and flags) where the LOD levels are keyed by their
+// parameters (GLYPH_OBJECT_MAX_STEPS, 2^level and flags).
+// The least recently used polygons are evicted when the
+// estimated size exceeds the budget. The size of a polygon
+// is estimated from its points since the tessellation is
+// not exposed by vkk_vg and covers the CPU and GPU copies of
+// the vertex and index buffers. An entry whose parameters
+// emit the same points as the most recently used entry of
+// the glyph shares its polygon rather than rebuilding it.
+//
+// The find, share and insert functions allow the polygons
+// to be built elsewhere (e.g. glyph_pool) where find is a
+// lookup which counts a hit, peek is a lookup which does
+// not update the LRU order, share adds an entry which shares
+// the polygon of the glyph and insert takes ownership of a
+// polygon built with the parameters. Build performs these
+// steps with a synchronous build. Share may compute the error
+// tables of the glyph so a glyph which is built concurrently
+// must be prepared (see glyph_object_prepare).
+//
+// The entries are indexed by a hash table whose bucket is
+// selected by the glyph alone so the entries of a glyph
+// share a bucket. Each bucket is ordered from the most
+// recently used entry which allows share to find the most
+// recently used entry of the glyph without walking the LRU
+// list.
+
+#define GLYPH_CACHE_BUDGET (4*1024*1024)
+
+typedef struct glyph_cache_s
+{
+	// estimated size of the polygons in bytes
+	size_t budget;
+	size_t size;
+
+	// entries are ordered from the most recently used head
+	// to the least recently used tail
+	struct glyph_cacheEntry_s* head;
+	struct glyph_cacheEntry_s* tail;
+
+	// hash table of 2^bits buckets
+	int                         count;
+	int                         bits;
+	struct glyph_cacheEntry_s** buckets;
+
+	// misses count the polygons which were built
+	int hits;
+	int misses;
+	int shares;
+	int evictions;
+} glyph_cache_t;
+
+glyph_cache_t*   glyph_cache_new(size_t budget);
+void             glyph_cache_delete(glyph_cache_t** _self);
+vkk_vgPolygon_t* glyph_cache_find(glyph_cache_t* self,
+                                  glyph_object_t* glyph,
+                                  int steps,
+                                  int thresh,
+                                  int flags);
+vkk_vgPolygon_t* glyph_cache_peek(glyph_cache_t* self,
+                                  glyph_object_t* glyph,
+                                  int steps,
+                                  int thresh,
+                                  int flags);
+vkk_vgPolygon_t* glyph_cache_share(glyph_cache_t* self,
+                                   glyph_object_t* glyph,
+                                   int steps,
+                                   int thresh,
+                                   int flags,
+                                   glyph_stats_t* stats);
+int              glyph_cache_insert(glyph_cache_t* self,
+                                    glyph_object_t* glyph,
+                                    int steps,
+                                    int thresh,
+                                    int flags,
+                                    vkk_vgPolygon_t* poly,
+                                    int points);
+vkk_vgPolygon_t* glyph_cache_build(glyph_cache_t* self,
+                                   glyph_object_t* glyph,
+                                   vkk_vgPolygonBuilder_t* pb,
+                                   int steps,
+                                   int thresh,
+                                   int flags,
+                                   glyph_stats_t* stats);
+void             glyph_cache_dump(glyph_cache_t* self);
+
+#endif
@@ -0,0 +1,1108 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph-check"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_arena.h"
+#include "glyph_bezier.h"
+#include "glyph_font.h"
+#include "glyph_object.h"
+#include "glyph_parser.h"
+#include "glyph_resource.h"
+#include "glyph_sink.h"
+
+// the segment count is not a multiple of the vector width
+// so the kernel tails are also checked
+#define GLYPH_CHECK_SEGMENTS 4099
+#define GLYPH_CHECK_SEED     0x2545F491
+
+// the parser benchmark is the best of several runs
+#define GLYPH_CHECK_RUNS 5
+
+// the batch check requires that the glyph builds fill the
+// widest vector (AVX2) on average
+#define GLYPH_CHECK_BATCH_WIDTH 8
+#define GLYPH_CHECK_BATCH_FSA   0
+#define GLYPH_CHECK_BATCH_ASA   1
+#define GLYPH_CHECK_BATCH_COUNT 2
+
+// the arena check evicts meshes in FIFO or LIFO order from
+// a small arena which forces holes, compactions and grows
+#define GLYPH_CHECK_ARENA_FIFO   0
+#define GLYPH_CHECK_ARENA_LIFO   1
+#define GLYPH_CHECK_ARENA_MESHES 64
+#define GLYPH_CHECK_ARENA_OPS    20000
+#define GLYPH_CHECK_ARENA_UPLOAD 7
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static float glyph_check_random(unsigned int* _seed)
+{
+	ASSERT(_seed);
+
+	*_seed = 1664525*(*_seed) + 1013904223;
+	return ((float) (*_seed >> 8))/((float) (1 << 24));
+}
+
+static int
+glyph_check_kernel(int kernel, int count, float** p,
+                   float* rx, float* ry, float* x, float* y)
+{
+	ASSERT(p);
+	ASSERT(rx);
+	ASSERT(ry);
+	ASSERT(x);
+	ASSERT(y);
+
+	// unsupported kernels are skipped
+	if(glyph_bezier_select(kernel) == 0)
+	{
+		printf("kernel=%i: skipped\n", kernel);
+		return 1;
+	}
+
+	const char* name = glyph_bezier_name();
+
+	int steps;
+	for(steps = 1; steps <= GLYPH_OBJECT_MAX_STEPS; ++steps)
+	{
+		size_t size = count*(steps + 1)*sizeof(float);
+
+		glyph_bezier_select(GLYPH_BEZIER_KERNEL_SCALAR);
+		glyph_bezier_evaluate(count, p[0], p[1], p[2], p[3],
+		                      p[4], p[5], steps, rx, ry);
+
+		glyph_bezier_select(kernel);
+		glyph_bezier_evaluate(count, p[0], p[1], p[2], p[3],
+		                      p[4], p[5], steps, x, y);
+		if(memcmp(rx, x, size) || memcmp(ry, y, size))
+		{
+			LOGE("%s: steps=%i, count=%i differs from scalar",
+			     name, steps, count);
+			return 0;
+		}
+
+		// short batches from an unaligned offset only
+		// exercise the kernel tails
+		int n;
+		for(n = 1; n <= 16; ++n)
+		{
+			size = n*(steps + 1)*sizeof(float);
+			glyph_bezier_evaluate(n, &p[0][1], &p[1][1],
+			                      &p[2][1], &p[3][1],
+			                      &p[4][1], &p[5][1],
+			                      steps, x, y);
+			if(memcmp(&rx[steps + 1], x, size) ||
+			   memcmp(&ry[steps + 1], y, size))
+			{
+				LOGE("%s: steps=%i, count=%i differs from scalar",
+				     name, steps, n);
+				return 0;
+			}
+		}
+	}
+
+	printf("kernel=%s: identical to scalar\n", name);
+
+	return 1;
+}
+
+static int
+glyph_check_forward(int count, float** p,
+                    float* rx, float* ry, float* x, float* y)
+{
+	ASSERT(p);
+	ASSERT(rx);
+	ASSERT(ry);
+	ASSERT(x);
+	ASSERT(y);
+
+	float err      = 0.0f;
+	float errCubic = 0.0f;
+
+	int s;
+	int i;
+	int steps;
+	for(steps = 1; steps <= GLYPH_OBJECT_MAX_STEPS; ++steps)
+	{
+		for(s = 0; s < count; ++s)
+		{
+			// quadratic samples i=1..steps
+			glyph_bezier_evaluate(1, &p[0][s], &p[1][s],
+			                      &p[2][s], &p[3][s],
+			                      &p[4][s], &p[5][s],
+			                      steps, rx, ry);
+			glyph_bezier_forward(p[0][s], p[1][s],
+			                     p[2][s], p[3][s],
+			                     p[4][s], p[5][s],
+			                     steps, x, y);
+			if((x[steps - 1] != p[4][s]) ||
+			   (y[steps - 1] != p[5][s]))
+			{
+				LOGE("forward: steps=%i, s=%i end point drift",
+				     steps, s);
+				return 0;
+			}
+
+			for(i = 0; i < steps; ++i)
+			{
+				err = fmaxf(err, fabsf(x[i] - rx[i + 1]));
+				err = fmaxf(err, fabsf(y[i] - ry[i + 1]));
+			}
+
+			// cubic samples i=1..steps
+			glyph_bezier_evaluateCubic(p[0][s], p[1][s],
+			                           p[2][s], p[3][s],
+			                           p[4][s], p[5][s],
+			                           p[6][s], p[7][s],
+			                           steps, rx, ry);
+			glyph_bezier_forwardCubic(p[0][s], p[1][s],
+			                          p[2][s], p[3][s],
+			                          p[4][s], p[5][s],
+			                          p[6][s], p[7][s],
+			                          steps, x, y);
+			if((x[steps - 1] != p[6][s]) ||
+			   (y[steps - 1] != p[7][s]))
+			{
+				LOGE("forwardCubic: steps=%i, s=%i end point drift",
+				     steps, s);
+				return 0;
+			}
+
+			for(i = 0; i < steps; ++i)
+			{
+				errCubic = fmaxf(errCubic,
+				                 fabsf(x[i] - rx[i + 1]));
+				errCubic = fmaxf(errCubic,
+				                 fabsf(y[i] - ry[i + 1]));
+			}
+		}
+	}
+
+	printf("forward: err=%g, tol=%g\n",
+	       err, GLYPH_BEZIER_FORWARD_TOL);
+	printf("forwardCubic: err=%g, tol=%g\n",
+	       errCubic, GLYPH_BEZIER_FORWARD_CUBIC_TOL);
+
+	if(err > GLYPH_BEZIER_FORWARD_TOL)
+	{
+		LOGE("forward: err=%g exceeds tol=%g",
+		     err, GLYPH_BEZIER_FORWARD_TOL);
+		return 0;
+	}
+	else if(errCubic > GLYPH_BEZIER_FORWARD_CUBIC_TOL)
+	{
+		LOGE("forwardCubic: err=%g exceeds tol=%g",
+		     errCubic, GLYPH_BEZIER_FORWARD_CUBIC_TOL);
+		return 0;
+	}
+
+	return 1;
+}
+
+static int glyph_check_bezier(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	if(argc != 2)
+	{
+		LOGE("usage: %s bezier", argv[0]);
+		return 0;
+	}
+
+	// control points x0, y0, x1, y1, x2, y2, x3, y3 followed
+	// by the reference and kernel samples
+	int    count   = GLYPH_CHECK_SEGMENTS;
+	size_t samples = count*(GLYPH_OBJECT_MAX_STEPS + 1);
+
+	float* buf;
+	buf = (float*)
+	      CALLOC(8*count + 4*samples, sizeof(float));
+	if(buf == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	float* p[8];
+	int    i;
+	for(i = 0; i < 8; ++i)
+	{
+		p[i] = &buf[i*count];
+	}
+
+	float* rx = &buf[8*count];
+	float* ry = &rx[samples];
+	float* x  = &ry[samples];
+	float* y  = &x[samples];
+
+	// segments in [0,1] where the first segment is
+	// degenerate and the second is a line
+	unsigned int seed = GLYPH_CHECK_SEED;
+	int          s;
+	for(s = 0; s < count; ++s)
+	{
+		for(i = 0; i < 8; ++i)
+		{
+			p[i][s] = glyph_check_random(&seed);
+		}
+	}
+
+	for(i = 1; i < 8; ++i)
+	{
+		p[i][0] = p[i%2][0];
+	}
+
+	for(i = 2; i < 8; ++i)
+	{
+		p[i][1] = p[i%2][1] + ((float) (i/2))*0.25f;
+	}
+
+	if((glyph_check_kernel(GLYPH_BEZIER_KERNEL_SSE, count,
+	                       p, rx, ry, x, y) == 0) ||
+	   (glyph_check_kernel(GLYPH_BEZIER_KERNEL_AVX2, count,
+	                       p, rx, ry, x, y) == 0) ||
+	   (glyph_check_kernel(GLYPH_BEZIER_KERNEL_NEON, count,
+	                       p, rx, ry, x, y) == 0))
+	{
+		goto fail_check;
+	}
+
+	glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+
+	if(glyph_check_forward(count, p, rx, ry, x, y) == 0)
+	{
+		goto fail_check;
+	}
+
+	FREE(buf);
+
+	// success
+	return 1;
+
+	// failure
+	fail_check:
+		glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+		FREE(buf);
+	return 0;
+}
+
+static int
+glyph_check_token(const char* data, size_t size,
+                  size_t* _pos, size_t* _len)
+{
+	ASSERT(data);
+	ASSERT(_pos);
+	ASSERT(_len);
+
+	// find the next number outside of a string
+	size_t pos = *_pos;
+	while(pos < size)
+	{
+		char c = data[pos];
+		if(c == '"')
+		{
+			++pos;
+			while((pos < size) && (data[pos] != '"'))
+			{
+				pos += (data[pos] == '\\') ? 2 : 1;
+			}
+			++pos;
+		}
+		else if((c == '-') || ((c >= '0') && (c <= '9')))
+		{
+			break;
+		}
+		else
+		{
+			++pos;
+		}
+	}
+
+	if(pos >= size)
+	{
+		return 0;
+	}
+
+	size_t len = 0;
+	while((pos + len < size) &&
+	      (strchr(",:]} \t\r\n", data[pos + len]) == NULL))
+	{
+		++len;
+	}
+
+	*_pos = pos;
+	*_len = len;
+
+	return 1;
+}
+
+static double
+glyph_check_parseTime(const char* data, size_t size,
+                      int fast, float* _sum)
+{
+	ASSERT(data);
+	ASSERT(_sum);
+
+	// the reference copies each token like the parser
+	// fallback and calls strtof
+	double best = 0.0;
+	int    run;
+	for(run = 0; run < GLYPH_CHECK_RUNS; ++run)
+	{
+		float  sum = 0.0f;
+		size_t pos = 0;
+		size_t len = 0;
+		double t0  = cc_timestamp();
+		while(glyph_check_token(data, size, &pos, &len))
+		{
+			float val = 0.0f;
+			if(fast)
+			{
+				glyph_parser_t parser;
+				glyph_parser_init(&parser, &data[pos], size - pos);
+				glyph_parser_float(&parser, &val);
+			}
+			else
+			{
+				char buf[64];
+				memcpy(buf, &data[pos], len);
+				buf[len] = '\0';
+				val = strtof(buf, NULL);
+			}
+			sum += val;
+			pos += len;
+		}
+
+		double dt = cc_timestamp() - t0;
+		if((run == 0) || (dt < best))
+		{
+			best = dt;
+		}
+		*_sum = sum;
+	}
+
+	return best;
+}
+
+static int glyph_check_parser(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	if(argc != 3)
+	{
+		LOGE("usage: %s parser font.json", argv[0]);
+		return 0;
+	}
+
+	glyph_resource_t* res;
+	res = glyph_resource_openFile(argv[2]);
+	if(res == NULL)
+	{
+		return 0;
+	}
+
+	const char* data  = res->data;
+	size_t      size  = res->size;
+	size_t      pos   = 0;
+	size_t      len   = 0;
+	int         count = 0;
+	int         ints  = 0;
+	while(glyph_check_token(data, size, &pos, &len))
+	{
+		char buf[64];
+		if(len >= 64)
+		{
+			LOGE("invalid len=%i", (int) len);
+			goto fail_check;
+		}
+		memcpy(buf, &data[pos], len);
+		buf[len] = '\0';
+
+		// every number must be bit-identical to strtof and
+		// consume the whole token
+		glyph_parser_t parser;
+		float          val = 0.0f;
+		float          ref = strtof(buf, NULL);
+		glyph_parser_init(&parser, &data[pos], size - pos);
+		if((glyph_parser_float(&parser, &val) == 0) ||
+		   (parser.pos != len) ||
+		   memcmp(&val, &ref, sizeof(float)))
+		{
+			LOGE("float: %s differs from strtof", buf);
+			goto fail_check;
+		}
+
+		// integers must also match strtol
+		if(strchr(buf, '.') == NULL)
+		{
+			int ival = 0;
+			glyph_parser_init(&parser, &data[pos], size - pos);
+			if((glyph_parser_int(&parser, &ival) == 0) ||
+			   (parser.pos != len) ||
+			   (ival != (int) strtol(buf, NULL, 0)))
+			{
+				LOGE("int: %s differs from strtol", buf);
+				goto fail_check;
+			}
+			++ints;
+		}
+
+		++count;
+		pos += len;
+	}
+
+	printf("parser: count=%i, ints=%i, identical to strtof\n",
+	       count, ints);
+
+	float  sum_ref  = 0.0f;
+	float  sum_fast = 0.0f;
+	double dt_ref   = glyph_check_parseTime(data, size, 0,
+	                                        &sum_ref);
+	double dt_fast  = glyph_check_parseTime(data, size, 1,
+	                                        &sum_fast);
+	if(sum_ref != sum_fast)
+	{
+		LOGE("invalid sum=%f/%f", sum_ref, sum_fast);
+		goto fail_check;
+	}
+
+	printf("strtof: %.1f Mvalues/s\n", 1.0e-6*count/dt_ref);
+	printf("parser: %.1f Mvalues/s\n", 1.0e-6*count/dt_fast);
+
+	glyph_resource_close(&res);
+
+	// success
+	return 1;
+
+	// failure
+	fail_check:
+		glyph_resource_close(&res);
+	return 0;
+}
+
+static int
+glyph_check_emit(glyph_object_t* glyph, glyph_sink_t* sink,
+                 int build, glyph_stats_t* stats)
+{
+	ASSERT(glyph);
+	ASSERT(sink);
+	ASSERT(stats);
+
+	// FSA with 16 steps or ASA with thresh=8
+	int steps  = GLYPH_OBJECT_MAX_STEPS;
+	int thresh = 0;
+	if(build == GLYPH_CHECK_BATCH_ASA)
+	{
+		thresh = 8;
+	}
+
+	glyph_sink_reset(sink);
+	return glyph_object_emit(glyph, sink, steps, thresh, 0,
+	                         stats);
+}
+
+static int
+glyph_check_kernelBatch(glyph_font_t* font, int kernel,
+                        glyph_sink_t* ref, glyph_sink_t* sink)
+{
+	ASSERT(font);
+	ASSERT(ref);
+	ASSERT(sink);
+
+	if(glyph_bezier_select(kernel) == 0)
+	{
+		printf("kernel=%i: skipped\n", kernel);
+		return 1;
+	}
+
+	const char* name = glyph_bezier_name();
+
+	int b;
+	int i;
+	int count = glyph_font_count(font);
+	for(b = 0; b < GLYPH_CHECK_BATCH_COUNT; ++b)
+	{
+		glyph_stats_t stats;
+		glyph_stats_reset(&stats);
+		for(i = 0; i < count; ++i)
+		{
+			glyph_object_t* glyph;
+			glyph = glyph_font_glyph(font, i);
+
+			// emit the reference points with the scalar kernel
+			glyph_stats_t tmp;
+			glyph_stats_reset(&tmp);
+			glyph_bezier_select(GLYPH_BEZIER_KERNEL_SCALAR);
+			if(glyph_check_emit(glyph, ref, b, &tmp) == 0)
+			{
+				return 0;
+			}
+
+			glyph_bezier_select(kernel);
+			if(glyph_check_emit(glyph, sink, b, &stats) == 0)
+			{
+				return 0;
+			}
+
+			if((sink->np != ref->np) || (sink->nc != ref->nc) ||
+			   (memcmp(sink->xy, ref->xy,
+			           2*ref->np*sizeof(float)) != 0))
+			{
+				LOGE("kernel=%s: glyph=%s differs from scalar",
+				     name, glyph_object_name(glyph));
+				return 0;
+			}
+		}
+
+		float average = 0.0f;
+		if(stats.batches)
+		{
+			average = ((float) stats.batched)/
+			          ((float) stats.batches);
+		}
+
+		printf("kernel=%s: %s batches=%i, batched=%i, average=%.1f\n",
+		       name, (b == GLYPH_CHECK_BATCH_ASA) ? "ASA" : "FSA",
+		       stats.batches, stats.batched, average);
+
+		// fonts without conics have no batches
+		if(stats.batches &&
+		   (average < (float) GLYPH_CHECK_BATCH_WIDTH))
+		{
+			LOGE("kernel=%s: average=%f below width=%i",
+			     name, average, GLYPH_CHECK_BATCH_WIDTH);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int glyph_check_batch(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	if(argc != 3)
+	{
+		LOGE("usage: %s batch font.json", argv[0]);
+		return 0;
+	}
+
+	glyph_font_t* font = glyph_font_newFile(argv[2], 0);
+	if(font == NULL)
+	{
+		return 0;
+	}
+
+	glyph_sink_t* ref = glyph_sink_new(NULL, NULL);
+	if(ref == NULL)
+	{
+		goto fail_ref;
+	}
+
+	glyph_sink_t* sink = glyph_sink_new(NULL, NULL);
+	if(sink == NULL)
+	{
+		goto fail_sink;
+	}
+
+	if((glyph_check_kernelBatch(font, GLYPH_BEZIER_KERNEL_SSE,
+	                            ref, sink) == 0) ||
+	   (glyph_check_kernelBatch(font, GLYPH_BEZIER_KERNEL_AVX2,
+	                            ref, sink) == 0) ||
+	   (glyph_check_kernelBatch(font, GLYPH_BEZIER_KERNEL_NEON,
+	                            ref, sink) == 0))
+	{
+		goto fail_check;
+	}
+
+	glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+	glyph_sink_delete(&sink);
+	glyph_sink_delete(&ref);
+	glyph_font_delete(&font);
+
+	// success
+	return 1;
+
+	// failure
+	fail_check:
+		glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+		glyph_sink_delete(&sink);
+	fail_sink:
+		glyph_sink_delete(&ref);
+	fail_ref:
+		glyph_font_delete(&font);
+	return 0;
+}
+
+typedef struct
+{
+	int id;
+
+	glyph_arenaMesh_t mesh;
+} glyph_checkMesh_t;
+
+typedef struct
+{
+	// GPU image of the arena which is updated from the
+	// dirty offsets
+	uint32_t  max_vertices;
+	uint32_t  max_indices;
+	float*    vertices;
+	uint16_t* indices;
+} glyph_checkImage_t;
+
+static void
+glyph_check_write(glyph_arena_t* arena, glyph_checkMesh_t* m)
+{
+	ASSERT(arena);
+	ASSERT(m);
+
+	// vertices are (id,k) and indices are relative
+	float*    v  = glyph_arena_vertices(arena, &m->mesh);
+	uint16_t* ix = glyph_arena_indices(arena, &m->mesh);
+	uint32_t  k;
+	for(k = 0; k < m->mesh.vc; ++k)
+	{
+		v[2*k]     = (float) m->id;
+		v[2*k + 1] = (float) k;
+	}
+
+	for(k = 0; k < m->mesh.ic; ++k)
+	{
+		ix[k] = (uint16_t) ((7*k)%m->mesh.vc);
+	}
+}
+
+static int
+glyph_check_read(const float* vertices,
+                 const uint16_t* indices,
+                 glyph_checkMesh_t* m)
+{
+	ASSERT(vertices);
+	ASSERT(indices);
+	ASSERT(m);
+
+	const float*    v  = &vertices[2*m->mesh.vb];
+	const uint16_t* ix = &indices[m->mesh.ib];
+	uint32_t        k;
+	for(k = 0; k < m->mesh.vc; ++k)
+	{
+		if((v[2*k] != (float) m->id) ||
+		   (v[2*k + 1] != (float) k))
+		{
+			LOGE("invalid id=%i, vertex=%u", m->id, k);
+			return 0;
+		}
+	}
+
+	for(k = 0; k < m->mesh.ic; ++k)
+	{
+		if(ix[k] != (uint16_t) ((7*k)%m->mesh.vc))
+		{
+			LOGE("invalid id=%i, index=%u", m->id, k);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int
+glyph_check_upload(glyph_arena_t* arena,
+                   glyph_checkImage_t* image)
+{
+	ASSERT(arena);
+	ASSERT(image);
+
+	// grown buffers are recreated from the dirty offsets
+	// which must cover the whole arena
+	if((image->max_vertices != arena->max_vertices) ||
+	   (image->max_indices  != arena->max_indices))
+	{
+		if(arena->dirty_vertices || arena->dirty_indices)
+		{
+			LOGE("invalid dirty=%u/%u after grow",
+			     arena->dirty_vertices, arena->dirty_indices);
+			return 0;
+		}
+
+		float* vertices;
+		vertices = (float*)
+		           REALLOC(image->vertices,
+		                   2*arena->max_vertices*sizeof(float));
+		if(vertices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		image->vertices     = vertices;
+		image->max_vertices = arena->max_vertices;
+
+		uint16_t* indices;
+		indices = (uint16_t*)
+		          REALLOC(image->indices,
+		                  arena->max_indices*sizeof(uint16_t));
+		if(indices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		image->indices     = indices;
+		image->max_indices = arena->max_indices;
+	}
+
+	uint32_t dv = arena->dirty_vertices;
+	uint32_t di = arena->dirty_indices;
+	if(dv < arena->top_vertices)
+	{
+		memcpy((void*) &image->vertices[2*dv],
+		       (const void*) &arena->vertices[2*dv],
+		       2*(arena->top_vertices - dv)*sizeof(float));
+	}
+	if(di < arena->top_indices)
+	{
+		memcpy((void*) &image->indices[di],
+		       (const void*) &arena->indices[di],
+		       (arena->top_indices - di)*sizeof(uint16_t));
+	}
+
+	glyph_arena_clean(arena);
+	if((arena->dirty_vertices != arena->top_vertices) ||
+	   (arena->dirty_indices  != arena->top_indices))
+	{
+		LOGE("invalid dirty=%u/%u after clean",
+		     arena->dirty_vertices, arena->dirty_indices);
+		return 0;
+	}
+
+	return 1;
+}
+
+static int
+glyph_check_evict(glyph_arena_t* arena, int policy,
+                  glyph_checkMesh_t** order, int* _live)
+{
+	ASSERT(arena);
+	ASSERT(order);
+	ASSERT(_live);
+
+	int live = *_live;
+	int i    = (policy == GLYPH_CHECK_ARENA_FIFO) ? 0 : live - 1;
+
+	glyph_checkMesh_t* m = order[i];
+
+	// freeing a mesh never modifies the buffers
+	uint32_t dv = arena->dirty_vertices;
+	uint32_t di = arena->dirty_indices;
+	glyph_arena_free(arena, &m->mesh);
+	m->id = 0;
+	if((arena->dirty_vertices != dv) ||
+	   (arena->dirty_indices  != di))
+	{
+		LOGE("invalid dirty=%u/%u after free",
+		     arena->dirty_vertices, arena->dirty_indices);
+		return 0;
+	}
+
+	memmove((void*) &order[i], (const void*) &order[i + 1],
+	        (live - i - 1)*sizeof(glyph_checkMesh_t*));
+	order[live - 1] = m;
+	*_live = live - 1;
+
+	return 1;
+}
+
+static int
+glyph_check_alloc(glyph_arena_t* arena, int id,
+                  glyph_checkMesh_t* m, unsigned int* _seed)
+{
+	ASSERT(arena);
+	ASSERT(m);
+	ASSERT(_seed);
+
+	uint32_t vc = 3 + (uint32_t) (250.0f*glyph_check_random(_seed));
+	uint32_t ic = 3*(vc - 2);
+
+	uint32_t dv          = arena->dirty_vertices;
+	uint32_t di          = arena->dirty_indices;
+	uint32_t max_v       = arena->max_vertices;
+	int      compactions = arena->compactions;
+	if(glyph_arena_alloc(arena, &m->mesh, vc, ic) == 0)
+	{
+		return 0;
+	}
+	m->id = id;
+
+	// a new mesh at the top only lowers the dirty offsets
+	// to the new mesh unless the arena was rearranged
+	if((arena->compactions == compactions) &&
+	   (arena->max_vertices == max_v))
+	{
+		uint32_t ev = (m->mesh.vb < dv) ? m->mesh.vb : dv;
+		uint32_t ei = (m->mesh.ib < di) ? m->mesh.ib : di;
+		if((arena->dirty_vertices != ev) ||
+		   (arena->dirty_indices  != ei))
+		{
+			LOGE("invalid dirty=%u/%u after alloc, expected=%u/%u",
+			     arena->dirty_vertices, arena->dirty_indices,
+			     ev, ei);
+			return 0;
+		}
+	}
+
+	glyph_check_write(arena, m);
+
+	return 1;
+}
+
+static int
+glyph_check_policy(int policy, const char* name)
+{
+	ASSERT(name);
+
+	glyph_checkImage_t image;
+	memset((void*) &image, 0, sizeof(glyph_checkImage_t));
+
+	glyph_checkMesh_t* meshes;
+	meshes = (glyph_checkMesh_t*)
+	         CALLOC(GLYPH_CHECK_ARENA_MESHES,
+	                sizeof(glyph_checkMesh_t));
+	if(meshes == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	// live meshes in allocation order followed by the
+	// free meshes
+	glyph_checkMesh_t* order[GLYPH_CHECK_ARENA_MESHES];
+	int i;
+	for(i = 0; i < GLYPH_CHECK_ARENA_MESHES; ++i)
+	{
+		order[i] = &meshes[i];
+	}
+
+	glyph_arena_t* arena = glyph_arena_new(1024, 1024);
+	if(arena == NULL)
+	{
+		goto fail_arena;
+	}
+
+	unsigned int seed = GLYPH_CHECK_SEED;
+	int          live = 0;
+	int          op;
+	for(op = 1; op <= GLYPH_CHECK_ARENA_OPS; ++op)
+	{
+		// the arena fills up and drains in phases
+		int fill = ((op/1000)%2) ? 3 : 7;
+		int r    = (int) (10.0f*glyph_check_random(&seed));
+		if((live == GLYPH_CHECK_ARENA_MESHES) ||
+		   ((live > 0) && (r >= fill)))
+		{
+			if(glyph_check_evict(arena, policy,
+			                     order, &live) == 0)
+			{
+				goto fail_check;
+			}
+		}
+		else
+		{
+			if(glyph_check_alloc(arena, op, order[live],
+			                     &seed) == 0)
+			{
+				goto fail_check;
+			}
+			++live;
+		}
+
+		// live meshes must survive compaction with
+		// relative indices
+		for(i = 0; i < live; ++i)
+		{
+			if(glyph_check_read(arena->vertices, arena->indices,
+			                    order[i]) == 0)
+			{
+				goto fail_check;
+			}
+		}
+
+		// the GPU image must match after uploading the
+		// dirty range
+		if((op%GLYPH_CHECK_ARENA_UPLOAD) == 0)
+		{
+			if(glyph_check_upload(arena, &image) == 0)
+			{
+				goto fail_check;
+			}
+
+			for(i = 0; i < live; ++i)
+			{
+				if(glyph_check_read(image.vertices, image.indices,
+				                    order[i]) == 0)
+				{
+					LOGE("%s: op=%i, stale image", name, op);
+					goto fail_check;
+				}
+			}
+		}
+	}
+
+	// FIFO eviction leaves holes which must be compacted
+	// while LIFO eviction frees the top mesh which never
+	// leaves a hole
+	if((policy == GLYPH_CHECK_ARENA_FIFO) &&
+	   (arena->compactions == 0))
+	{
+		LOGE("%s: compactions=0", name);
+		goto fail_check;
+	}
+	else if((policy == GLYPH_CHECK_ARENA_LIFO) &&
+	        (arena->moves != 0))
+	{
+		LOGE("%s: moves=%i", name, arena->moves);
+		goto fail_check;
+	}
+
+	printf("arena=%s: allocs=%i, frees=%i, grows=%i, compactions=%i, moves=%i\n",
+	       name, arena->allocs, arena->frees, arena->grows,
+	       arena->compactions, arena->moves);
+
+	while(live > 0)
+	{
+		if(glyph_check_evict(arena, policy,
+		                     order, &live) == 0)
+		{
+			goto fail_check;
+		}
+	}
+
+	if(arena->head || arena->top_vertices || arena->top_indices ||
+	   arena->used_vertices || arena->used_indices)
+	{
+		LOGE("%s: invalid empty arena", name);
+		goto fail_check;
+	}
+
+	glyph_arena_delete(&arena);
+	FREE(image.indices);
+	FREE(image.vertices);
+	FREE(meshes);
+
+	// success
+	return 1;
+
+	// failure
+	fail_check:
+		while(live > 0)
+		{
+			glyph_arena_free(arena, &order[--live]->mesh);
+		}
+		glyph_arena_delete(&arena);
+	fail_arena:
+		FREE(image.indices);
+		FREE(image.vertices);
+		FREE(meshes);
+	return 0;
+}
+
+static int glyph_check_arena(int argc, char** argv)
+{
+	ASSERT(argv);
+
+	if(argc != 2)
+	{
+		LOGE("usage: %s arena", argv[0]);
+		return 0;
+	}
+
+	if((glyph_check_policy(GLYPH_CHECK_ARENA_FIFO,
+	                       "fifo") == 0) ||
+	   (glyph_check_policy(GLYPH_CHECK_ARENA_LIFO,
+	                       "lifo") == 0))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* main                                                     *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	// bezier: checks that each kernel produces results
+	// identical to the scalar kernel and that the forward
+	// differencing emitters are within tolerance
+	if((argc >= 2) && (strcmp(argv[1], "bezier") == 0))
+	{
+		return glyph_check_bezier(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// parser: checks that each number of a font is parsed
+	// identically to strtof/strtol and measures the values
+	// parsed per second
+	if((argc >= 2) && (strcmp(argv[1], "parser") == 0))
+	{
+		return glyph_check_parser(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// batch: checks that the glyph builds evaluate the conics
+	// of a font in batches which fill the vectors of each
+	// kernel and that the points are identical to the
+	// scalar kernel
+	if((argc >= 2) && (strcmp(argv[1], "batch") == 0))
+	{
+		return glyph_check_batch(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// arena: checks the mesh arena with FIFO and LIFO
+	// eviction against a GPU image which is updated from
+	// the dirty offsets
+	if((argc >= 2) && (strcmp(argv[1], "arena") == 0))
+	{
+		return glyph_check_arena(argc, argv) ?
+		       EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	LOGE("usage: %s bezier", argv[0]);
+	LOGE("usage: %s parser font.json", argv[0]);
+	LOGE("usage: %s batch font.json", argv[0]);
+	LOGE("usage: %s arena", argv[0]);
+	return EXIT_FAILURE;
+}
@@ -21,15 +21,16 @@
  *
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #define LOG_TAG "glyph"
-#include "libbfs/bfs_file.h"
 #include "libbfs/bfs_util.h"
 #include "libcc/cc_log.h"
 #include "libcc/cc_memory.h"
 #include "libcc/cc_timestamp.h"
+#include "libcc/math/cc_vec4f.h"
 #include "libvkk/vkk_platform.h"
 #include "glyph_engine.h"
 #include "glyph_object.h"
@@ -38,156 +39,323 @@
 * private                                                  *
 ***********************************************************/
 
-static int
-glyph_engine_addGlyph(glyph_engine_t* self,
-                      jsmn_val_t* val)
+static vkk_vgPolygon_t*
+glyph_engine_defaultPoly(glyph_engine_t* self)
 {
 	ASSERT(self);
-	ASSERT(val);
 
-	if(val->type != JSMN_TYPE_OBJECT)
+	vkk_vgPolygonBuilder_t* pb = self->vg_polygon_builder;
+
+	vkk_vgPolygonBuilder_reset(pb);
+	if(vkk_vgPolygonBuilder_point(pb, 1, 2.5f, 2.5f) &&
+	   vkk_vgPolygonBuilder_point(pb, 0, 2.5f, 7.5f) &&
+	   vkk_vgPolygonBuilder_point(pb, 0, 7.5f, 7.5f) &&
+	   vkk_vgPolygonBuilder_point(pb, 0, 7.5f, 2.5f) &&
+	   vkk_vgPolygonBuilder_point(pb, 0, 2.5f, 2.5f))
 	{
-		LOGE("invalid type=%i", val->type);
-		return 0;
+		return vkk_vgPolygonBuilder_build(pb);
 	}
 
-	glyph_object_t* glyph = glyph_object_new(val->obj);
-	if(glyph == NULL)
+	return NULL;
+}
+
+static void
+glyph_engine_glyphMvp(glyph_object_t* glyph, cc_mat4f_t* mvp)
+{
+	ASSERT(glyph);
+	ASSERT(mvp);
+
+	// center the glyph box (w x h) in a square of height h
+	// which is mapped onto the viewport
+	float l = -(glyph->h - glyph->w)/2.0f;
+	cc_mat4f_orthoVK(mvp, 1, l, l + glyph->h,
+	                 glyph->h, 0.0f, 0.0f, 2.0f);
+}
+
+static float
+glyph_engine_projectHeight(const cc_mat4f_t* mvp,
+                           float x, float y, float h,
+                           float viewport_h)
+{
+	ASSERT(mvp);
+
+	// project the bottom and top of the glyph box where the
+	// viewport spans 2 units of normalized device coordinates
+	cc_vec4f_t p0 = { .x = x, .y = y,     .z = 0.0f, .w = 1.0f };
+	cc_vec4f_t p1 = { .x = x, .y = y + h, .z = 0.0f, .w = 1.0f };
+	cc_vec4f_t c0;
+	cc_vec4f_t c1;
+	cc_mat4f_mulv_copy(mvp, &p0, &c0);
+	cc_mat4f_mulv_copy(mvp, &p1, &c1);
+	if((c0.w <= 0.0f) || (c1.w <= 0.0f))
 	{
-		return 0;
+		return 0.0f;
 	}
 
-	if(cc_map_addf(self->map_glyph, glyph, "%s",
-	               glyph->name) == NULL)
+	return 0.5f*viewport_h*fabsf(c1.y/c1.w - c0.y/c0.w);
+}
+
+static void glyph_engine_collect(glyph_engine_t* self)
+{
+	ASSERT(self);
+
+	// transfer the completed polygons to the cache
+	glyph_poolJob_t* job = glyph_pool_collect(self->pool);
+	while(job)
 	{
-		goto fail_add;
-	}
+		job->glyph->stats = job->stats;
+		glyph_stats_add(&self->stats, &job->stats);
 
-	// success
-	return 1;
+		if(job->poly)
+		{
+			glyph_cache_insert(self->cache, job->glyph,
+			                   job->steps, job->thresh,
+			                   job->flags, job->poly,
+			                   job->stats.points);
+			job->poly = NULL;
+		}
 
-	// failure
-	fail_add:
-		glyph_object_delete(&glyph);
-	return 0;
+		glyph_poolJob_delete(&job);
+		job = glyph_pool_collect(self->pool);
+	}
 }
 
-static int
-glyph_engine_addGlyphs(glyph_engine_t* self,
-                       jsmn_val_t* root)
+static vkk_vgPolygon_t*
+glyph_engine_polygon(glyph_engine_t* self,
+                     glyph_object_t* glyph,
+                     int steps, int thresh, int flags,
+                     int* _pending)
 {
 	ASSERT(self);
-	ASSERT(root);
+	ASSERT(glyph);
+	ASSERT(_pending);
+
+	// pending is set when the polygon is not available yet
+	// but a build is in flight
+	*_pending = 0;
 
-	if(root->type != JSMN_TYPE_ARRAY)
+	vkk_vgPolygon_t* poly;
+	poly = glyph_cache_find(self->cache, glyph,
+	                        steps, thresh, flags);
+	if(poly)
 	{
-		LOGE("invalid type=%i", root->type);
-		return 0;
+		return poly;
 	}
 
-	cc_listIter_t* iter = cc_list_head(root->array->list);
-	while(iter)
+	if(glyph_pool_find(self->pool, glyph, steps, thresh, flags))
 	{
-		jsmn_val_t* val;
-		val = (jsmn_val_t*) cc_list_peekIter(iter);
-		if(glyph_engine_addGlyph(self, val) == 0)
-		{
-			goto fail_add_glyph;
-		}
+		*_pending = 1;
+		return NULL;
+	}
 
-		iter = cc_list_next(iter);
+	// the build failed previously and would fail again
+	if(glyph_pool_failed(self->pool, glyph, steps, thresh, flags))
+	{
+		return NULL;
 	}
 
-	// success
-	return 1;
+	// glyphs which cannot produce a polygon
+	// e.g. space character
+	if(glyph_object_prepare(glyph) == 0)
+	{
+		return NULL;
+	}
 
-	// failure
-	fail_add_glyph:
+	poly = glyph_cache_share(self->cache, glyph,
+	                         steps, thresh, flags,
+	                         &self->stats);
+	if(poly)
 	{
-		cc_mapIter_t* miter = cc_map_head(self->map_glyph);
-		while(miter)
-		{
-			glyph_object_t* glyph;
-			glyph = (glyph_object_t*)
-			        cc_map_remove(self->map_glyph, &miter);
-			glyph_object_delete(&glyph);
-		}
+		return poly;
 	}
-	return 0;
+
+	// build the polygon asynchronously
+	*_pending = glyph_pool_submit(self->pool, glyph,
+	                              steps, thresh, flags);
+	return NULL;
 }
 
-static int
-glyph_engine_loadGlyphs(glyph_engine_t* self)
+static glyph_arenaMesh_t*
+glyph_engine_mesh(glyph_engine_t* self,
+                  glyph_object_t* glyph,
+                  int steps, int thresh, int flags)
 {
 	ASSERT(self);
+	ASSERT(glyph);
 
-	char resource[256];
-	snprintf(resource, 256, "%s/resource.bfs",
-	         vkk_engine_internalPath(self->engine));
+	glyph_engineMesh_t* lru = &self->meshes[0];
 
-	bfs_file_t* bfs;
-	bfs = bfs_file_open(resource, 1, BFS_MODE_RDONLY);
-	if(bfs == NULL)
+	int i;
+	for(i = 0; i < GLYPH_ENGINE_MESH_COUNT; ++i)
 	{
-		return 0;
+		glyph_engineMesh_t* entry = &self->meshes[i];
+		if((entry->glyph  == glyph)  &&
+		   (entry->steps  == steps)  &&
+		   (entry->thresh == thresh) &&
+		   (entry->flags  == flags))
+		{
+			entry->stamp = ++self->mesh_stamp;
+			return entry->failed ? NULL : &entry->mesh;
+		}
+
+		if(entry->stamp < lru->stamp)
+		{
+			lru = entry;
+		}
 	}
 
-	size_t size = 0;
-	char*  str  = NULL;
-	if(bfs_file_blobGet(bfs, 0,
-	                    "BarlowSemiCondensed-Regular.json",
-	                    &size, (void**) &str) == 0)
+	// glyphs which cannot produce a mesh
+	// e.g. space character
+	if(glyph_object_prepare(glyph) == 0)
 	{
-		goto fail_bfs;
+		return NULL;
 	}
 
-	jsmn_val_t* root = jsmn_val_new(str, size);
-	if(root == NULL)
+	// replace the least recently used mesh
+	if(lru->glyph && (lru->failed == 0))
 	{
-		goto fail_jsmn;
+		glyph_arena_free(self->arena, &lru->mesh);
 	}
 
-	if(glyph_engine_addGlyphs(self, root) == 0)
+	lru->glyph  = glyph;
+	lru->steps  = steps;
+	lru->thresh = thresh;
+	lru->flags  = flags;
+	lru->failed = 0;
+	lru->stamp  = ++self->mesh_stamp;
+
+	// a store hit skips the subdivision and tessellation
+	int           ret;
+	glyph_stats_t stats;
+	if(self->store)
+	{
+		ret = glyph_store_build(self->store, glyph, self->sink,
+		                        self->tess, self->arena,
+		                        &lru->mesh, steps, thresh,
+		                        flags, &stats);
+	}
+	else
 	{
-		goto fail_add_glyphs;
+		ret = glyph_object_buildMesh(glyph, self->sink,
+		                             self->tess, self->arena,
+		                             &lru->mesh, steps, thresh,
+		                             flags, &stats);
 	}
 
-	// cleanup
-	jsmn_val_delete(&root);
-	FREE(str);
-	bfs_file_close(&bfs);
+	if(ret == 0)
+	{
+		LOGE("invalid glyph=%s", glyph_object_name(glyph));
+		lru->failed = 1;
+	}
 
-	// success
-	return 1;
+	glyph->stats = stats;
+	glyph_stats_add(&self->stats, &stats);
 
-	// failure
-	fail_add_glyphs:
-		jsmn_val_delete(&root);
-	fail_jsmn:
-		FREE(str);
-	fail_bfs:
-		bfs_file_close(&bfs);
-	return 0;
+	return lru->failed ? NULL : &lru->mesh;
 }
 
-static vkk_vgPolygon_t*
-glyph_engine_defaultPoly(glyph_engine_t* self)
+static void glyph_engine_sampleText(glyph_engine_t* self)
 {
 	ASSERT(self);
 
-	vkk_vgPolygonBuilder_t* pb = self->vg_polygon_builder;
+	vkk_vgPolygonStyle_t title_style =
+	{
+		.color =
+		{
+			.r = 1.0f,
+			.g = 1.0f,
+			.b = 1.0f,
+			.a = 1.0f,
+		}
+	};
 
-	vkk_vgPolygonBuilder_reset(pb);
-	if(vkk_vgPolygonBuilder_point(pb, 1, 2.5f, 2.5f) &&
-	   vkk_vgPolygonBuilder_point(pb, 0, 2.5f, 7.5f) &&
-	   vkk_vgPolygonBuilder_point(pb, 0, 7.5f, 7.5f) &&
-	   vkk_vgPolygonBuilder_point(pb, 0, 7.5f, 2.5f) &&
-	   vkk_vgPolygonBuilder_point(pb, 0, 2.5f, 2.5f))
+	vkk_vgPolygonStyle_t body_style =
 	{
-		return vkk_vgPolygonBuilder_build(pb);
+		.color =
+		{
+			.r = 1.0f,
+			.g = 0.0f,
+			.b = 1.0f,
+			.a = 1.0f,
+		}
+	};
+
+	glyph_object_t* space;
+	space = glyph_font_lookup(self->font, ' ');
+	if((space == NULL) || (space->h <= 0.0f))
+	{
+		return;
 	}
 
-	return NULL;
+	// the run is laid out in pixels
+	float scale = GLYPH_ENGINE_TEXT_SIZE/space->h;
+	float x     = GLYPH_ENGINE_TEXT_SIZE;
+	float y     = GLYPH_ENGINE_TEXT_SIZE;
+
+	glyph_text_t* text  = self->text;
+	int           title = glyph_text_style(text, &title_style);
+	int           body  = glyph_text_style(text, &body_style);
+	if((title < 0) || (body < 0))
+	{
+		return;
+	}
+
+	glyph_text_add(text, "Adaptive Subdivision",
+	               x, y, scale, title);
+	glyph_text_add(text,
+	               "The quick brown fox jumps over the lazy dog.\n"
+	               "Pack my box with five dozen liquor jugs!\n"
+	               "Sphinx of black quartz, judge my vow.\n"
+	               "0123456789 (+-*/=) \"Glyph\"",
+	               x, y + 2.0f*GLYPH_ENGINE_TEXT_SIZE,
+	               scale, body);
+}
+
+static void
+glyph_engine_drawText(glyph_engine_t* self,
+                      float screen_w, float screen_h)
+{
+	ASSERT(self);
+
+	glyph_text_t* text = self->text;
+
+	// the projection maps the run coordinates to pixels
+	cc_mat4f_t mvp;
+	cc_mat4f_orthoVK(&mvp, 1, 0.0f, screen_w,
+	                 screen_h, 0.0f, 0.0f, 2.0f);
+
+	int steps  = self->glyph_steps;
+	int thresh = self->glyph_thresh;
+	if(self->glyph_lod)
+	{
+		// the level is selected for the projected size of
+		// the first glyph since the run is built with a
+		// single set of parameters
+		glyph_textGlyph_t* g = &text->glyphs[0];
+		float height = glyph_engine_projectHeight(&mvp, g->x, g->y,
+		                                          g->scale*g->glyph->h,
+		                                          screen_h);
+		self->text_level = glyph_object_lodLevel(g->glyph,
+		                                         GLYPH_ENGINE_LOD_TOLERANCE,
+		                                         height,
+		                                         self->text_level);
+		if(self->text_level < 0)
+		{
+			return;
+		}
+
+		steps  = GLYPH_OBJECT_MAX_STEPS;
+		thresh = 1 << self->text_level;
+	}
+
+	// a failed build keeps the previous polygons
+	glyph_text_build(text, self->vg_polygon_builder,
+	                 steps, thresh, self->glyph_flags,
+	                 &self->stats);
+
+	vkk_vgContext_reset(self->vg_context, &mvp);
+	vkk_vgContext_bindPolygons(self->vg_context);
+	glyph_text_draw(text, self->vg_context);
 }
 
 /***********************************************************
@@ -211,6 +379,9 @@ glyph_engine_t* glyph_engine_new(vkk_engine_t* engine)
 	self->glyph_i      = 'g';
 	self->glyph_steps  = 16;
 	self->glyph_thresh = 0;
+	self->glyph_flags  = GLYPH_OBJECT_FLAG_FORWARD;
+	self->glyph_level  = -1;
+	self->text_level   = -1;
 
 	if(bfs_util_initialize() == 0)
 	{
@@ -238,24 +409,81 @@ glyph_engine_t* glyph_engine_new(vkk_engine_t* engine)
 		goto fail_default_poly;
 	}
 
-	self->map_glyph = cc_map_new();
-	if(self->map_glyph == NULL)
+	self->font = glyph_font_new(vkk_engine_internalPath(engine),
+	                            "BarlowSemiCondensed-Regular",
+	                            GLYPH_FONT_FLAG_LAZY);
+	if(self->font == NULL)
+	{
+		goto fail_font;
+	}
+
+	self->cache = glyph_cache_new(GLYPH_CACHE_BUDGET);
+	if(self->cache == NULL)
+	{
+		goto fail_cache;
+	}
+
+	self->pool = glyph_pool_new(engine);
+	if(self->pool == NULL)
+	{
+		goto fail_pool;
+	}
+
+	self->text = glyph_text_new(self->font);
+	if(self->text == NULL)
 	{
-		goto fail_map_glyph;
+		goto fail_text;
 	}
 
-	if(glyph_engine_loadGlyphs(self) == 0)
+	self->sink = glyph_sink_new(NULL, NULL);
+	if(self->sink == NULL)
 	{
-		goto fail_load_glyphs;
+		goto fail_sink;
 	}
 
+	self->tess = glyph_tess_new();
+	if(self->tess == NULL)
+	{
+		goto fail_tess;
+	}
+
+	self->arena = glyph_arena_new(0, 0);
+	if(self->arena == NULL)
+	{
+		goto fail_arena;
+	}
+
+	self->renderer = glyph_renderer_new(engine);
+	if(self->renderer == NULL)
+	{
+		goto fail_renderer;
+	}
+
+	// the mesh store is optional
+	char fname[256];
+	snprintf(fname, 256, "%s/mesh.bfs",
+	         vkk_engine_internalPath(engine));
+	self->store = glyph_store_new(self->font, fname, 1);
+
 	// success
 	return self;
 
 	// failure
-	fail_load_glyphs:
-		cc_map_delete(&self->map_glyph);
-	fail_map_glyph:
+	fail_renderer:
+		glyph_arena_delete(&self->arena);
+	fail_arena:
+		glyph_tess_delete(&self->tess);
+	fail_tess:
+		glyph_sink_delete(&self->sink);
+	fail_sink:
+		glyph_text_delete(&self->text);
+	fail_text:
+		glyph_pool_delete(&self->pool);
+	fail_pool:
+		glyph_cache_delete(&self->cache);
+	fail_cache:
+		glyph_font_delete(&self->font);
+	fail_font:
 		vkk_vgPolygon_delete(&self->default_poly);
 	fail_default_poly:
 		vkk_vgPolygonBuilder_delete(&self->vg_polygon_builder);
@@ -275,16 +503,15 @@ void glyph_engine_delete(glyph_engine_t** _self)
 	glyph_engine_t* self = *_self;
 	if(self)
 	{
-		cc_mapIter_t* miter = cc_map_head(self->map_glyph);
-		while(miter)
-		{
-			glyph_object_t* glyph;
-			glyph = (glyph_object_t*)
-			        cc_map_remove(self->map_glyph, &miter);
-			glyph_object_delete(&glyph);
-		}
-
-		cc_map_delete(&self->map_glyph);
+		glyph_store_delete(&self->store);
+		glyph_renderer_delete(&self->renderer);
+		glyph_arena_delete(&self->arena);
+		glyph_tess_delete(&self->tess);
+		glyph_sink_delete(&self->sink);
+		glyph_text_delete(&self->text);
+		glyph_pool_delete(&self->pool);
+		glyph_cache_delete(&self->cache);
+		glyph_font_delete(&self->font);
 		vkk_vgPolygon_delete(&self->default_poly);
 		vkk_vgPolygonBuilder_delete(&self->vg_polygon_builder);
 		vkk_vgContext_delete(&self->vg_context);
@@ -296,6 +523,33 @@ void glyph_engine_delete(glyph_engine_t** _self)
 void glyph_engine_pause(glyph_engine_t* self)
 {
 	ASSERT(self);
+
+	glyph_engine_dumpStats(self);
+}
+
+void glyph_engine_dumpStats(glyph_engine_t* self)
+{
+	ASSERT(self);
+
+	glyph_object_t* glyph;
+	glyph = glyph_font_lookup(self->font,
+	                          (uint32_t) self->glyph_i);
+	if(glyph)
+	{
+		glyph_stats_dump(&glyph->stats,
+		                 glyph_object_name(glyph));
+	}
+
+	glyph_stats_dump(&self->stats, "engine");
+	glyph_cache_dump(self->cache);
+	glyph_pool_dump(self->pool);
+	glyph_arena_dump(self->arena);
+	glyph_renderer_dump(self->renderer);
+
+	if(self->store)
+	{
+		glyph_store_dump(self->store);
+	}
 }
 
 void glyph_engine_draw(glyph_engine_t* self)
@@ -347,32 +601,96 @@ void glyph_engine_draw(glyph_engine_t* self)
 		                     self->content_rect_height);
 	}
 
-	float l = 0.0f;
-	float r = 10.0f;
-	float b = 10.0f;
-	float t = 0.0f;
+	// the glyph which frames the polygon or mesh
+	vkk_vgPolygon_t*   poly  = self->default_poly;
+	glyph_arenaMesh_t* mesh  = NULL;
+	glyph_object_t*    frame = NULL;
 
-	vkk_vgPolygon_t* poly = self->default_poly;
+	glyph_engine_collect(self);
 
-	cc_mapIter_t* miter;
-	miter = cc_map_findf(self->map_glyph, "ascii-0x%X",
-	                     self->glyph_i);
-	if(miter)
+	if(self->text->count)
 	{
-		glyph_object_t* glyph;
-		glyph = (glyph_object_t*) cc_map_val(miter);
+		glyph_engine_drawText(self, screen_w, screen_h);
+		vkk_renderer_end(rend);
+		return;
+	}
+
+	glyph_object_t* glyph;
+	glyph = glyph_font_lookup(self->font,
+	                          (uint32_t) self->glyph_i);
+	if(glyph)
+	{
+		// the LOD is selected for the projected height of the
+		// glyph with the projection of its polygon
+		cc_mat4f_t glyph_mvp;
+		glyph_engine_glyphMvp(glyph, &glyph_mvp);
+		float height = glyph_engine_projectHeight(&glyph_mvp,
+		                                          0.0f, 0.0f,
+		                                          glyph->h,
+		                                          screen_h);
+
+		int steps  = self->glyph_steps;
+		int thresh = self->glyph_thresh;
+		int valid  = 1;
+		if(self->glyph_lod)
+		{
+			// LOD levels are built with thresh=2^level
+			self->glyph_level = glyph_object_lodLevel(glyph,
+			                                          GLYPH_ENGINE_LOD_TOLERANCE,
+			                                          height,
+			                                          self->glyph_level);
+			if(self->glyph_level >= 0)
+			{
+				steps  = GLYPH_OBJECT_MAX_STEPS;
+				thresh = 1 << self->glyph_level;
+			}
+			else
+			{
+				valid = 0;
+			}
+		}
+
+		vkk_vgPolygon_t* tmp     = NULL;
+		int              pending = 0;
+		if(valid && self->glyph_tess)
+		{
+			mesh = glyph_engine_mesh(self, glyph, steps, thresh,
+			                         self->glyph_flags);
+			if(mesh)
+			{
+				frame = glyph;
+			}
+		}
+		else if(valid)
+		{
+			tmp = glyph_engine_polygon(self, glyph, steps, thresh,
+			                           self->glyph_flags,
+			                           &pending);
+		}
+
+		if(tmp)
+		{
+			self->last_glyph  = glyph;
+			self->last_steps  = steps;
+			self->last_thresh = thresh;
+			self->last_flags  = self->glyph_flags;
+		}
+		else if(pending && self->last_glyph)
+		{
+			// draw the last polygon while the build is pending
+			// otherwise the glyph has no polygon and the
+			// default polygon is drawn
+			glyph = self->last_glyph;
+			tmp   = glyph_cache_peek(self->cache, glyph,
+			                         self->last_steps,
+			                         self->last_thresh,
+			                         self->last_flags);
+		}
 
-		vkk_vgPolygon_t* tmp;
-		tmp = glyph_object_build(glyph,
-		                         self->vg_polygon_builder,
-		                         self->glyph_steps,
-		                         self->glyph_thresh);
 		if(tmp)
 		{
-			poly = tmp;
-			b    = glyph->h;
-			l    = -(glyph->h - glyph->w)/2.0f;
-			r    = l + glyph->h;
+			poly  = tmp;
+			frame = glyph;
 		}
 	}
 
@@ -387,13 +705,32 @@ void glyph_engine_draw(glyph_engine_t* self)
 		}
 	};
 
+	// the default polygon is drawn in a 10x10 box
 	cc_mat4f_t mvp;
-	cc_mat4f_orthoVK(&mvp, 1, l, r,
-	                 b, t, 0.0f, 2.0f);
-	vkk_vgContext_reset(self->vg_context, &mvp);
-	vkk_vgContext_bindPolygons(self->vg_context);
-	vkk_vgPolygon_draw(poly, self->vg_context,
-	                   &vg_polygon_style);
+	if(frame)
+	{
+		glyph_engine_glyphMvp(frame, &mvp);
+	}
+	else
+	{
+		cc_mat4f_orthoVK(&mvp, 1, 0.0f, 10.0f,
+		                 10.0f, 0.0f, 0.0f, 2.0f);
+	}
+
+	if(mesh)
+	{
+		// the mesh color matches the polygon style
+		cc_vec4f_t color = { 1.0f, 0.0f, 1.0f, 1.0f };
+		glyph_renderer_draw(self->renderer, self->arena, mesh,
+		                    &mvp, &color);
+	}
+	else
+	{
+		vkk_vgContext_reset(self->vg_context, &mvp);
+		vkk_vgContext_bindPolygons(self->vg_context);
+		vkk_vgPolygon_draw(poly, self->vg_context,
+		                   &vg_polygon_style);
+	}
 	vkk_renderer_end(rend);
 }
 
@@ -440,10 +777,46 @@ void glyph_engine_event(glyph_engine_t* self,
 		{
 			self->glyph_thresh += 1;
 		}
+		else if(event->key.keycode == VKK_PLATFORM_KEYCODE_ENTER)
+		{
+			// toggle the ASA error metric
+			self->glyph_flags ^= GLYPH_OBJECT_FLAG_ANALYTIC;
+		}
+		else if(event->key.keycode == VKK_PLATFORM_KEYCODE_TAB)
+		{
+			// toggle recursive subdivision of ASA
+			self->glyph_flags ^= GLYPH_OBJECT_FLAG_RECURSIVE;
+		}
+		else if(event->key.keycode == VKK_PLATFORM_KEYCODE_BACKSPACE)
+		{
+			// toggle the pixel tolerance LOD
+			self->glyph_lod = 1 - self->glyph_lod;
+		}
+		else if(event->key.keycode == VKK_PLATFORM_KEYCODE_DELETE)
+		{
+			// toggle the sample text run
+			if(self->text->count)
+			{
+				glyph_text_clear(self->text);
+			}
+			else
+			{
+				glyph_engine_sampleText(self);
+			}
+			self->text_level = -1;
+		}
+		else if(event->key.keycode == VKK_PLATFORM_KEYCODE_INSERT)
+		{
+			// toggle the glyph tessellator and mesh arena
+			self->glyph_tess = 1 - self->glyph_tess;
+		}
 		else if((event->key.keycode >= 32) &&
 		        (event->key.keycode <= 126))
 		{
-			self->glyph_i = event->key.keycode;
+			// cancel the pending builds of the last glyph
+			self->glyph_i     = event->key.keycode;
+			self->glyph_level = -1;
+			glyph_pool_cancel(self->pool);
 		}
 	}
 	else if(event->type == VKK_PLATFORM_EVENTTYPE_CONTENT_RECT)
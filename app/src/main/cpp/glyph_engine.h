@@ -24,9 +24,45 @@
 #ifndef glyph_engine_H
 #define glyph_engine_H
 
-#include "libcc/cc_map.h"
 #include "libvkk/vkk.h"
 #include "libvkk/vkk_vg.h"
+#include "glyph_arena.h"
+#include "glyph_cache.h"
+#include "glyph_font.h"
+#include "glyph_pool.h"
+#include "glyph_renderer.h"
+#include "glyph_sink.h"
+#include "glyph_store.h"
+#include "glyph_tess.h"
+#include "glyph_text.h"
+
+// pixel tolerance for the glyph LOD
+#define GLYPH_ENGINE_LOD_TOLERANCE 0.5f
+
+// line height in pixels of the sample text run
+#define GLYPH_ENGINE_TEXT_SIZE 32.0f
+
+// number of glyph meshes retained in the mesh arena
+#define GLYPH_ENGINE_MESH_COUNT 64
+
+// The glyph meshes are built by the glyph tessellator into
+// the mesh arena when glyph_tess is set rather than by the
+// polygon pool. The meshes are loaded from the mesh store
+// when it holds them and otherwise they are built and
+// written back. The meshes are built synchronously since the
+// arena is not thread safe and the least recently used mesh
+// is freed when every entry is in use. A failed build is
+// retained as an entry without a mesh so it is not retried.
+typedef struct glyph_engineMesh_s
+{
+	glyph_object_t*   glyph;
+	int               steps;
+	int               thresh;
+	int               flags;
+	int               failed;
+	int               stamp;
+	glyph_arenaMesh_t mesh;
+} glyph_engineMesh_t;
 
 typedef struct glyph_engine_s
 {
@@ -37,8 +73,36 @@ typedef struct glyph_engine_s
 	int              glyph_i;
 	int              glyph_steps;
 	int              glyph_thresh;
+	int              glyph_flags;
+	int              glyph_lod;
+	int              glyph_level;
 	vkk_vgPolygon_t* default_poly;
-	cc_map_t*        map_glyph;
+	glyph_font_t*    font;
+	glyph_cache_t*   cache;
+	glyph_pool_t*    pool;
+
+	// glyph tessellator meshes
+	int                glyph_tess;
+	int                mesh_stamp;
+	glyph_sink_t*      sink;
+	glyph_tess_t*      tess;
+	glyph_arena_t*     arena;
+	glyph_renderer_t*  renderer;
+	glyph_store_t*     store;
+	glyph_engineMesh_t meshes[GLYPH_ENGINE_MESH_COUNT];
+
+	// the last polygon is drawn while a build is pending
+	glyph_object_t* last_glyph;
+	int             last_steps;
+	int             last_thresh;
+	int             last_flags;
+
+	// the text run replaces the glyph when it is not empty
+	glyph_text_t* text;
+	int           text_level;
+
+	// statistics accumulated across glyph builds
+	glyph_stats_t stats;
 
 	double   escape_t0;
 	uint32_t content_rect_top;
@@ -50,6 +114,7 @@ typedef struct glyph_engine_s
 glyph_engine_t* glyph_engine_new(vkk_engine_t* engine);
 void            glyph_engine_delete(glyph_engine_t** _self);
 void            glyph_engine_pause(glyph_engine_t* self);
+void            glyph_engine_dumpStats(glyph_engine_t* self);
 void            glyph_engine_draw(glyph_engine_t* self);
 void            glyph_engine_event(glyph_engine_t* self,
                                    vkk_platformEvent_t* event);
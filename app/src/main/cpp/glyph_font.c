@@ -0,0 +1,977 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_font.h"
+#include "glyph_parser.h"
+#include "glyph_resource.h"
+
+// maximum number of threads selected by
+// GLYPH_FONT_FLAG_THREADED
+#define GLYPH_FONT_MAX_THREADS 8
+
+// minimum number of JSON bytes decoded per thread
+#define GLYPH_FONT_MIN_CHUNK 65536
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct
+{
+	// per-thread arena
+	glyph_font_t arena;
+
+	glyph_font_t* font;
+	const char*   data;
+	int           begin;
+	int           end;
+	int           status;
+	pthread_t     thread;
+} glyph_fontWorker_t;
+
+static int
+glyph_font_grow(glyph_font_t* self, int size_p, int size_c)
+{
+	ASSERT(self);
+	ASSERT(self->pack == NULL);
+
+	// the arena is a single block with the layout
+	// x[size_p], y[size_p], c[size_c], t[size_p]
+	size_t size = ((size_t) size_p)*(2*sizeof(float) +
+	                                 sizeof(uint8_t)) +
+	              ((size_t) size_c)*sizeof(int32_t);
+	char* arena = (char*) MALLOC(size);
+	if(arena == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+
+	float*   x = (float*) arena;
+	float*   y = &x[size_p];
+	int32_t* c = (int32_t*) &y[size_p];
+	uint8_t* t = (uint8_t*) &c[size_c];
+	if(self->x)
+	{
+		memcpy(x, self->x, self->np*sizeof(float));
+		memcpy(y, self->y, self->np*sizeof(float));
+		memcpy(c, self->c, self->nc*sizeof(int32_t));
+		memcpy(t, self->t, self->np*sizeof(uint8_t));
+		FREE(self->x);
+	}
+
+	self->size_p = size_p;
+	self->size_c = size_c;
+	self->x      = x;
+	self->y      = y;
+	self->c      = c;
+	self->t      = t;
+
+	return 1;
+}
+
+static int glyph_font_newGlyph(glyph_font_t* self)
+{
+	ASSERT(self);
+
+	if(self->count == self->max_glyphs)
+	{
+		int max_glyphs = self->max_glyphs ?
+		                 2*self->max_glyphs : 128;
+
+		glyph_object_t* glyphs;
+		glyphs = (glyph_object_t*)
+		         REALLOC(self->glyphs,
+		                 max_glyphs*sizeof(glyph_object_t));
+		if(glyphs == NULL)
+		{
+			LOGE("REALLOC failed");
+			return -1;
+		}
+
+		self->glyphs     = glyphs;
+		self->max_glyphs = max_glyphs;
+	}
+
+	int idx = self->count;
+	memset((void*) &self->glyphs[idx], 0,
+	       sizeof(glyph_object_t));
+	++self->count;
+
+	return idx;
+}
+
+static int
+glyph_font_indexCode(glyph_font_t* self,
+                     glyph_object_t* glyph)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	uint32_t code = glyph->code;
+	if(code == GLYPH_PACK_CODE_NONE)
+	{
+		return 1;
+	}
+
+	glyph_object_t** slot;
+	if(code < GLYPH_FONT_LATIN_COUNT)
+	{
+		slot = &self->latin[code];
+	}
+	else
+	{
+		if(self->pages == NULL)
+		{
+			self->pages = (glyph_object_t***)
+			              CALLOC(GLYPH_FONT_PAGE_COUNT,
+			                     sizeof(glyph_object_t**));
+			if(self->pages == NULL)
+			{
+				LOGE("CALLOC failed");
+				return 0;
+			}
+		}
+
+		glyph_object_t*** page;
+		page = &self->pages[code >> GLYPH_FONT_PAGE_SHIFT];
+		if(*page == NULL)
+		{
+			*page = (glyph_object_t**)
+			        CALLOC(GLYPH_FONT_PAGE_SIZE,
+			               sizeof(glyph_object_t*));
+			if(*page == NULL)
+			{
+				LOGE("CALLOC failed");
+				return 0;
+			}
+		}
+
+		slot = &(*page)[code & (GLYPH_FONT_PAGE_SIZE - 1)];
+	}
+
+	// the first glyph for a code point takes priority
+	if(*slot == NULL)
+	{
+		*slot = glyph;
+	}
+
+	return 1;
+}
+
+static int glyph_font_index(glyph_font_t* self)
+{
+	ASSERT(self);
+
+	// the glyph array is fixed once loading completes
+	int i;
+	for(i = 0; i < self->count; ++i)
+	{
+		glyph_object_t* glyph = &self->glyphs[i];
+		if(cc_map_add(self->map_glyph, glyph,
+		              glyph_object_name(glyph)) == NULL)
+		{
+			LOGE("invalid name=%s", glyph_object_name(glyph));
+			return 0;
+		}
+
+		if(glyph_font_indexCode(self, glyph) == 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int
+glyph_font_loadPack(glyph_font_t* self, const char* path,
+                    const char* name)
+{
+	ASSERT(self);
+	ASSERT(path);
+	ASSERT(name);
+
+	char fname[256];
+	snprintf(fname, 256, "%s.gpk", name);
+
+	self->pack = glyph_pack_open(path, fname);
+	if(self->pack == NULL)
+	{
+		return 0;
+	}
+
+	// the arena is borrowed from the pack
+	glyph_pack_t* pack = self->pack;
+	self->np         = (int) pack->header->np;
+	self->nc         = (int) pack->header->nc;
+	self->x          = (float*)   pack->x;
+	self->y          = (float*)   pack->y;
+	self->c          = (int32_t*) pack->c;
+	self->t          = (uint8_t*) pack->t;
+	self->names      = (char*)    pack->names;
+	self->size_names = pack->header->size_names;
+
+	// glyphs are views of the pack so a single allocation
+	// covers the entire font
+	int count = (int) glyph_pack_count(pack);
+	if(count)
+	{
+		self->glyphs = (glyph_object_t*)
+		               CALLOC(count, sizeof(glyph_object_t));
+		if(self->glyphs == NULL)
+		{
+			LOGE("CALLOC failed");
+			return 0;
+		}
+		self->max_glyphs = count;
+	}
+
+	int i;
+	for(i = 0; i < count; ++i)
+	{
+		glyph_object_initPack(&self->glyphs[i], self, pack, i);
+	}
+	self->count = count;
+
+	return glyph_font_index(self);
+}
+
+static int glyph_font_threads(size_t size, int flags)
+{
+	// see GLYPH_FONT_FLAG_THREADS
+	int threads = flags >> GLYPH_FONT_THREADS_SHIFT;
+	if(threads > 0)
+	{
+		return threads;
+	}
+
+	threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads > GLYPH_FONT_MAX_THREADS)
+	{
+		threads = GLYPH_FONT_MAX_THREADS;
+	}
+
+	// small fonts are not worth the thread overhead
+	int chunks = (int) (size/GLYPH_FONT_MIN_CHUNK);
+	if(threads > chunks)
+	{
+		threads = chunks;
+	}
+
+	return (threads > 1) ? threads : 1;
+}
+
+static void* glyph_font_workerMain(void* arg)
+{
+	ASSERT(arg);
+
+	glyph_fontWorker_t* worker = (glyph_fontWorker_t*) arg;
+	glyph_font_t*       font   = worker->font;
+
+	// glyphs in the chunk are decoded into the per-thread
+	// arena and the shared names are read-only
+	int i;
+	for(i = worker->begin; i < worker->end; ++i)
+	{
+		glyph_object_t* glyph = &font->glyphs[i];
+		glyph->font = &worker->arena;
+		if(glyph_object_decode(glyph, worker->data) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	worker->status = 1;
+	return NULL;
+}
+
+static int
+glyph_font_decodeThreads(glyph_font_t* self,
+                         glyph_resource_t* res, int flags)
+{
+	ASSERT(self);
+	ASSERT(res);
+
+	int threads = glyph_font_threads(res->size, flags);
+	if(threads > self->count)
+	{
+		threads = self->count;
+	}
+
+	if(threads == 0)
+	{
+		return 1;
+	}
+
+	glyph_fontWorker_t* workers;
+	workers = (glyph_fontWorker_t*)
+	          CALLOC(threads, sizeof(glyph_fontWorker_t));
+	if(workers == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	// split the glyphs into contiguous chunks with a
+	// similar number of bytes to decode
+	size_t total = 0;
+	int    i;
+	for(i = 0; i < self->count; ++i)
+	{
+		total += self->glyphs[i].size;
+	}
+
+	int    begin = 0;
+	size_t bytes = 0;
+	int    t;
+	for(t = 0; t < threads; ++t)
+	{
+		glyph_fontWorker_t* worker = &workers[t];
+
+		size_t target = total*(t + 1)/threads;
+		int    end    = begin;
+		while((end < self->count) &&
+		      ((bytes < target) || (t == threads - 1)))
+		{
+			bytes += self->glyphs[end].size;
+			++end;
+		}
+
+		worker->arena.names      = self->names;
+		worker->arena.size_names = self->size_names;
+		worker->font             = self;
+		worker->data             = res->data;
+		worker->begin            = begin;
+		worker->end              = end;
+		begin = end;
+	}
+
+	// the calling thread decodes the first chunk
+	int started;
+	for(started = 1; started < threads; ++started)
+	{
+		glyph_fontWorker_t* worker = &workers[started];
+		if(pthread_create(&worker->thread, NULL,
+		                  glyph_font_workerMain,
+		                  (void*) worker) != 0)
+		{
+			LOGE("pthread_create failed");
+			break;
+		}
+	}
+
+	glyph_font_workerMain((void*) &workers[0]);
+
+	for(t = 1; t < started; ++t)
+	{
+		pthread_join(workers[t].thread, NULL);
+	}
+
+	// merge the per-thread arenas in chunk order so the
+	// result is identical to the serial path
+	int status = (started == threads);
+	int np     = 0;
+	int nc     = 0;
+	for(t = 0; t < threads; ++t)
+	{
+		status &= workers[t].status;
+		np     += workers[t].arena.np;
+		nc     += workers[t].arena.nc;
+	}
+
+	if(status && ((np > self->size_p) || (nc > self->size_c)))
+	{
+		status = glyph_font_grow(self, np, nc);
+	}
+
+	for(t = 0; t < threads; ++t)
+	{
+		glyph_fontWorker_t* worker = &workers[t];
+		glyph_font_t*       arena  = &worker->arena;
+
+		for(i = worker->begin; i < worker->end; ++i)
+		{
+			glyph_object_t* glyph = &self->glyphs[i];
+			glyph->font = self;
+			glyph->p   += self->np;
+			glyph->c   += self->nc;
+		}
+
+		if(status)
+		{
+			memcpy(&self->x[self->np], arena->x,
+			       arena->np*sizeof(float));
+			memcpy(&self->y[self->np], arena->y,
+			       arena->np*sizeof(float));
+			memcpy(&self->c[self->nc], arena->c,
+			       arena->nc*sizeof(int32_t));
+			memcpy(&self->t[self->np], arena->t,
+			       arena->np*sizeof(uint8_t));
+			self->np += arena->np;
+			self->nc += arena->nc;
+		}
+
+		FREE(arena->x);
+	}
+	FREE(workers);
+
+	return status;
+}
+
+static int
+glyph_font_loadStream(glyph_font_t* self,
+                      glyph_resource_t* res, int flags)
+{
+	ASSERT(self);
+	ASSERT(res);
+
+	// glyphs are decoded in a single forward pass over the
+	// borrowed view directly into the arena or scanned for
+	// their names and byte ranges when loaded lazily or
+	// decoded by multiple threads
+	int scan = flags & (GLYPH_FONT_FLAG_LAZY |
+	                    GLYPH_FONT_FLAG_THREADED);
+
+	glyph_parser_t parser;
+	glyph_parser_init(&parser, res->data, res->size);
+	if(glyph_parser_expect(&parser, '[') == 0)
+	{
+		return 0;
+	}
+
+	while(glyph_parser_accept(&parser, ']') == 0)
+	{
+		int idx = glyph_font_newGlyph(self);
+		if(idx < 0)
+		{
+			return 0;
+		}
+
+		glyph_object_t* glyph = &self->glyphs[idx];
+		if(scan)
+		{
+			if(glyph_object_scan(glyph, self, &parser) == 0)
+			{
+				return 0;
+			}
+		}
+		else if(glyph_object_parse(glyph, self, &parser) == 0)
+		{
+			return 0;
+		}
+
+		if(glyph_parser_next(&parser, ']') == 0)
+		{
+			return 0;
+		}
+	}
+
+	if(((flags & GLYPH_FONT_FLAG_LAZY) == 0) &&
+	   (flags & GLYPH_FONT_FLAG_THREADED))
+	{
+		if(glyph_font_decodeThreads(self, res, flags) == 0)
+		{
+			return 0;
+		}
+	}
+
+	return glyph_font_index(self);
+}
+
+static glyph_object_t*
+glyph_font_decode(glyph_font_t* self, glyph_object_t* glyph)
+{
+	ASSERT(self);
+
+	if((glyph == NULL) || (glyph->lazy == 0))
+	{
+		return glyph;
+	}
+
+	ASSERT(self->res);
+
+	if(glyph_object_decode(glyph, self->res->data) == 0)
+	{
+		return NULL;
+	}
+
+	return glyph;
+}
+
+static int
+glyph_font_write(FILE* f, const void* data, size_t size)
+{
+	ASSERT(f);
+
+	if(size == 0)
+	{
+		return 1;
+	}
+
+	if(fwrite(data, size, 1, f) != 1)
+	{
+		LOGE("fwrite failed");
+		return 0;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_font_t*
+glyph_font_new(const char* path, const char* name,
+               int flags)
+{
+	ASSERT(path);
+	ASSERT(name);
+
+	glyph_font_t* self;
+	self = (glyph_font_t*) CALLOC(1, sizeof(glyph_font_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->map_glyph = cc_map_new();
+	if(self->map_glyph == NULL)
+	{
+		goto fail_map_glyph;
+	}
+
+	double t0 = cc_timestamp();
+
+	// prefer the precompiled glyphs
+	if(glyph_font_loadPack(self, path, name))
+	{
+		LOGI("PACK(%s): count=%i, np=%i, dt=%lf",
+		     name, self->count, self->np, cc_timestamp() - t0);
+		return self;
+	}
+	else if(self->pack)
+	{
+		goto fail_load;
+	}
+
+	char fname[256];
+	snprintf(fname, 256, "%s.json", name);
+
+	glyph_resource_t* res = glyph_resource_open(path, fname);
+	if(res == NULL)
+	{
+		goto fail_load;
+	}
+
+	if(glyph_font_loadStream(self, res, flags) == 0)
+	{
+		glyph_resource_close(&res);
+		goto fail_load;
+	}
+
+	// lazy glyphs are decoded from the resource on demand
+	if(flags & GLYPH_FONT_FLAG_LAZY)
+	{
+		self->res = res;
+	}
+	else
+	{
+		glyph_resource_close(&res);
+	}
+
+	LOGI("STREAM(%s): count=%i, np=%i, lazy=%i, dt=%lf",
+	     name, self->count, self->np,
+	     (flags & GLYPH_FONT_FLAG_LAZY) ? 1 : 0,
+	     cc_timestamp() - t0);
+
+	// success
+	return self;
+
+	// failure
+	fail_load:
+		glyph_font_delete(&self);
+	return NULL;
+	fail_map_glyph:
+		FREE(self);
+	return NULL;
+}
+
+glyph_font_t*
+glyph_font_newFile(const char* fname, int flags)
+{
+	ASSERT(fname);
+
+	glyph_font_t* self;
+	self = (glyph_font_t*) CALLOC(1, sizeof(glyph_font_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->map_glyph = cc_map_new();
+	if(self->map_glyph == NULL)
+	{
+		goto fail_map_glyph;
+	}
+
+	glyph_resource_t* res = glyph_resource_openFile(fname);
+	if(res == NULL)
+	{
+		goto fail_load;
+	}
+
+	if(glyph_font_loadStream(self, res, flags) == 0)
+	{
+		glyph_resource_close(&res);
+		goto fail_load;
+	}
+
+	// lazy glyphs are decoded from the resource on demand
+	if(flags & GLYPH_FONT_FLAG_LAZY)
+	{
+		self->res = res;
+	}
+	else
+	{
+		glyph_resource_close(&res);
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_load:
+		glyph_font_delete(&self);
+	return NULL;
+	fail_map_glyph:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_font_delete(glyph_font_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_font_t* self = *_self;
+	if(self)
+	{
+		int i;
+		for(i = 0; i < self->count; ++i)
+		{
+			glyph_object_finish(&self->glyphs[i]);
+		}
+
+		if(self->pages)
+		{
+			for(i = 0; i < GLYPH_FONT_PAGE_COUNT; ++i)
+			{
+				FREE(self->pages[i]);
+			}
+			FREE(self->pages);
+		}
+
+		cc_map_discard(self->map_glyph);
+		cc_map_delete(&self->map_glyph);
+		FREE(self->glyphs);
+
+		if(self->res)
+		{
+			glyph_resource_close(&self->res);
+		}
+
+		if(self->pack)
+		{
+			glyph_pack_close(&self->pack);
+		}
+		else
+		{
+			FREE(self->names);
+			FREE(self->x);
+		}
+
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_font_exportPack(glyph_font_t* self,
+                          const char* fname)
+{
+	ASSERT(self);
+	ASSERT(fname);
+
+	// the pack layout is little-endian
+	uint32_t endian = 1;
+	if(*((uint8_t*) &endian) != 1)
+	{
+		LOGE("big-endian is not supported");
+		return 0;
+	}
+
+	// the arena must be complete before the header is
+	// written
+	int i;
+	for(i = 0; i < self->count; ++i)
+	{
+		if(glyph_font_decode(self, &self->glyphs[i]) == NULL)
+		{
+			return 0;
+		}
+	}
+
+	glyph_packHeader_t header =
+	{
+		.magic      = GLYPH_PACK_MAGIC,
+		.version    = GLYPH_PACK_VERSION,
+		.count      = (uint32_t) self->count,
+		.np         = (uint32_t) self->np,
+		.nc         = (uint32_t) self->nc,
+		.size_names = self->size_names,
+	};
+
+	FILE* f = fopen(fname, "wb");
+	if(f == NULL)
+	{
+		LOGE("fopen failed fname=%s", fname);
+		return 0;
+	}
+
+	if(glyph_font_write(f, &header, sizeof(header)) == 0)
+	{
+		goto fail_write;
+	}
+
+	for(i = 0; i < self->count; ++i)
+	{
+		glyph_object_t* glyph = &self->glyphs[i];
+
+		glyph_packIndex_t idx =
+		{
+			.code = glyph->code,
+			.name = glyph->name,
+			.w    = glyph->w,
+			.h    = glyph->h,
+			.p    = (uint32_t) glyph->p,
+			.np   = (uint32_t) glyph->np,
+			.c    = (uint32_t) glyph->c,
+			.nc   = (uint32_t) glyph->nc,
+		};
+
+		if(glyph_font_write(f, &idx, sizeof(idx)) == 0)
+		{
+			goto fail_write;
+		}
+	}
+
+	// the arena matches the pack layout
+	if((glyph_font_write(f, self->x,
+	                     self->np*sizeof(float))   == 0) ||
+	   (glyph_font_write(f, self->y,
+	                     self->np*sizeof(float))   == 0) ||
+	   (glyph_font_write(f, self->c,
+	                     self->nc*sizeof(int32_t)) == 0) ||
+	   (glyph_font_write(f, self->t,
+	                     self->np*sizeof(uint8_t)) == 0) ||
+	   (glyph_font_write(f, self->names,
+	                     self->size_names)         == 0))
+	{
+		goto fail_write;
+	}
+
+	fclose(f);
+
+	LOGI("count=%u, np=%u, nc=%u, size=%i",
+	     header.count, header.np, header.nc,
+	     (int) glyph_pack_size(header.count, header.np,
+	                           header.nc, header.size_names));
+
+	// success
+	return 1;
+
+	// failure
+	fail_write:
+		fclose(f);
+		remove(fname);
+	return 0;
+}
+
+int glyph_font_count(glyph_font_t* self)
+{
+	ASSERT(self);
+
+	return self->count;
+}
+
+glyph_object_t* glyph_font_glyph(glyph_font_t* self, int idx)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx < self->count));
+
+	return glyph_font_decode(self, &self->glyphs[idx]);
+}
+
+glyph_object_t*
+glyph_font_find(glyph_font_t* self, const char* name)
+{
+	ASSERT(self);
+	ASSERT(name);
+
+	cc_mapIter_t* miter = cc_map_find(self->map_glyph, name);
+	if(miter == NULL)
+	{
+		return NULL;
+	}
+
+	return glyph_font_decode(self,
+	                         (glyph_object_t*) cc_map_val(miter));
+}
+
+glyph_object_t*
+glyph_font_lookup(glyph_font_t* self, uint32_t code)
+{
+	ASSERT(self);
+
+	if(code < GLYPH_FONT_LATIN_COUNT)
+	{
+		return glyph_font_decode(self, self->latin[code]);
+	}
+	else if((code > 0x10FFFF) || (self->pages == NULL))
+	{
+		return NULL;
+	}
+
+	glyph_object_t** page;
+	page = self->pages[code >> GLYPH_FONT_PAGE_SHIFT];
+	if(page == NULL)
+	{
+		return NULL;
+	}
+
+	return glyph_font_decode(self,
+	                         page[code & (GLYPH_FONT_PAGE_SIZE - 1)]);
+}
+
+int glyph_font_allocPoints(glyph_font_t* self, int np)
+{
+	ASSERT(self);
+	ASSERT(np >= 0);
+
+	if(self->np + np > self->size_p)
+	{
+		int size_p = self->size_p ? 2*self->size_p : 4096;
+		while(self->np + np > size_p)
+		{
+			size_p *= 2;
+		}
+
+		if(glyph_font_grow(self, size_p, self->size_c) == 0)
+		{
+			return -1;
+		}
+	}
+
+	int p = self->np;
+	memset((void*) &self->x[p], 0, np*sizeof(float));
+	memset((void*) &self->y[p], 0, np*sizeof(float));
+	memset((void*) &self->t[p], 0, np*sizeof(uint8_t));
+	self->np += np;
+
+	return p;
+}
+
+int glyph_font_allocContours(glyph_font_t* self, int nc)
+{
+	ASSERT(self);
+	ASSERT(nc >= 0);
+
+	if(self->nc + nc > self->size_c)
+	{
+		int size_c = self->size_c ? 2*self->size_c : 256;
+		while(self->nc + nc > size_c)
+		{
+			size_c *= 2;
+		}
+
+		if(glyph_font_grow(self, self->size_p, size_c) == 0)
+		{
+			return -1;
+		}
+	}
+
+	int c = self->nc;
+	memset((void*) &self->c[c], 0, nc*sizeof(int32_t));
+	self->nc += nc;
+
+	return c;
+}
+
+int glyph_font_allocName(glyph_font_t* self,
+                         const char* name, uint32_t len,
+                         uint32_t* _offset)
+{
+	ASSERT(self);
+	ASSERT(name);
+	ASSERT(_offset);
+	ASSERT(self->pack == NULL);
+
+	if(self->size_names + len + 1 > self->max_names)
+	{
+		uint32_t max_names = self->max_names ?
+		                     2*self->max_names : 1024;
+		while(self->size_names + len + 1 > max_names)
+		{
+			max_names *= 2;
+		}
+
+		char* names = (char*) REALLOC(self->names, max_names);
+		if(names == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->names     = names;
+		self->max_names = max_names;
+	}
+
+	*_offset = self->size_names;
+	memcpy(&self->names[self->size_names], name, len);
+	self->names[self->size_names + len] = '\0';
+	self->size_names += len + 1;
+
+	return 1;
+}
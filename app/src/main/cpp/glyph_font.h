@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_font_H
+#define glyph_font_H
+
+#include <stdint.h>
+
+#include "libcc/cc_map.h"
+#include "glyph_object.h"
+#include "glyph_pack.h"
+#include "glyph_resource.h"
+
+// load only the glyph names and byte ranges and decode the
+// remaining glyph data on the first lookup
+#define GLYPH_FONT_FLAG_LAZY 1
+
+// decode the glyphs in chunks across multiple threads
+// where GLYPH_FONT_FLAG_THREADS(n) selects n threads rather
+// than one per core (e.g. for benchmarking)
+#define GLYPH_FONT_FLAG_THREADED   2
+#define GLYPH_FONT_THREADS_SHIFT   8
+#define GLYPH_FONT_FLAG_THREADS(n) (GLYPH_FONT_FLAG_THREADED | \
+                                    ((n) << GLYPH_FONT_THREADS_SHIFT))
+
+// glyphs are indexed by code point with a dense table for
+// Basic Latin and Latin-1 and a two-level page table for the
+// remainder of Unicode
+#define GLYPH_FONT_LATIN_COUNT 256
+#define GLYPH_FONT_PAGE_SHIFT  8
+#define GLYPH_FONT_PAGE_SIZE   256
+#define GLYPH_FONT_PAGE_COUNT  (0x110000 >> GLYPH_FONT_PAGE_SHIFT)
+
+// The font owns a structure-of-arrays arena which holds the
+// outlines of every glyph. Glyphs are views which store
+// offsets into the arena so the arena may grow while the
+// font is loaded. The arena is borrowed from the glyph pack
+// when the font is loaded from a pack.
+
+typedef struct glyph_font_s
+{
+	// arena
+	int      np;
+	int      nc;
+	int      size_p;
+	int      size_c;
+	float*   x;
+	float*   y;
+	uint8_t* t;
+	int32_t* c;
+
+	// names
+	uint32_t size_names;
+	uint32_t max_names;
+	char*    names;
+
+	// glyphs
+	int             count;
+	int             max_glyphs;
+	glyph_object_t* glyphs;
+	cc_map_t*       map_glyph;
+
+	// code point lookup
+	glyph_object_t*   latin[GLYPH_FONT_LATIN_COUNT];
+	glyph_object_t*** pages;
+
+	// optional precompiled glyphs
+	glyph_pack_t* pack;
+
+	// resource retained for lazy glyphs
+	glyph_resource_t* res;
+} glyph_font_t;
+
+glyph_font_t*   glyph_font_new(const char* path,
+                               const char* name,
+                               int flags);
+glyph_font_t*   glyph_font_newFile(const char* fname,
+                                   int flags);
+void            glyph_font_delete(glyph_font_t** _self);
+int             glyph_font_exportPack(glyph_font_t* self,
+                                      const char* fname);
+int             glyph_font_count(glyph_font_t* self);
+glyph_object_t* glyph_font_glyph(glyph_font_t* self, int idx);
+glyph_object_t* glyph_font_find(glyph_font_t* self,
+                                const char* name);
+glyph_object_t* glyph_font_lookup(glyph_font_t* self,
+                                  uint32_t code);
+int             glyph_font_allocPoints(glyph_font_t* self,
+                                       int np);
+int             glyph_font_allocContours(glyph_font_t* self,
+                                         int nc);
+int             glyph_font_allocName(glyph_font_t* self,
+                                     const char* name,
+                                     uint32_t len,
+                                     uint32_t* _offset);
+
+#endif
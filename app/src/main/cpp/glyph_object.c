@@ -21,6 +21,7 @@
  *
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,740 +29,2323 @@
 #define LOG_TAG "glyph"
 #include "libcc/cc_log.h"
 #include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_bezier.h"
+#include "glyph_font.h"
 #include "glyph_object.h"
 
 /***********************************************************
 * private                                                  *
 ***********************************************************/
 
-static cc_vec2f_t*
-glyph_newPoints(int np, jsmn_array_t* array)
+// request full unrolling of loops with a constant trip count
+#if defined(__clang__)
+	#define GLYPH_OBJECT_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+	#define GLYPH_OBJECT_UNROLL _Pragma("GCC unroll 16")
+#else
+	#define GLYPH_OBJECT_UNROLL
+#endif
+
+// segments of the precompiled segment stream
+// a segment has type + 2 control points and the end point
+// is the last control point
+#define GLYPH_OBJECT_SEGMENT_LINE  0
+#define GLYPH_OBJECT_SEGMENT_CONIC 1
+#define GLYPH_OBJECT_SEGMENT_CUBIC 2
+
+// floats per coordinate of the conic batch buffer which
+// holds 60 conics evaluated with 16 steps
+#define GLYPH_OBJECT_BATCH_SIZE 1024
+
+// error tables of the sampled and analytic metrics
+// cubics always use the sampled metric
+#define GLYPH_OBJECT_ERROR_SAMPLED  0
+#define GLYPH_OBJECT_ERROR_ANALYTIC 1
+#define GLYPH_OBJECT_ERROR_COUNT    2
+
+typedef struct
 {
-	ASSERT(array);
+	float dist;
+	float e1;
+	float e2;
+	float e4;
+	float e8;
+} glyph_objectError_t;
+
+typedef struct glyph_objectSegment_s
+{
+	int type;
+
+	// first segment of a contour
+	int first;
+
+	// end point is an ON point rather than a virtual point
+	int on;
+
+	// index of the control points in the stream arrays of
+	// the segment type
+	int idx;
+
+	// error tables are computed on the first ASA build since
+	// they only depend on the outline
+	// errors is a mask of the valid tables
+	int                 errors;
+	glyph_objectError_t error[GLYPH_OBJECT_ERROR_COUNT];
+} glyph_objectSegment_t;
+
+// the control points are stored as SoA arrays per segment
+// type where qx[k][i] is control point k of conic i so that
+// the conics of a glyph are evaluated by one kernel call
+// lines only store the end point since the start point is
+// the end point of the previous segment
+typedef struct glyph_objectStream_s
+{
+	int                    ns;
+	glyph_objectSegment_t* segs;
+
+	int    nl;
+	float* lx;
+	float* ly;
+
+	int    nq;
+	float* qx[3];
+	float* qy[3];
+
+	int    nk;
+	float* kx[4];
+	float* ky[4];
+} glyph_objectStream_t;
+
+static void
+glyph_object_points(glyph_objectStream_t* stream,
+                    glyph_objectSegment_t* seg,
+                    cc_vec2f_t* p)
+{
+	ASSERT(stream);
+	ASSERT(seg);
+	ASSERT(p);
+
+	// gather the control points of a conic or cubic
+	int k;
+	int i = seg->idx;
+	if(seg->type == GLYPH_OBJECT_SEGMENT_CUBIC)
+	{
+		for(k = 0; k < 4; ++k)
+		{
+			p[k].x = stream->kx[k][i];
+			p[k].y = stream->ky[k][i];
+		}
+	}
+	else
+	{
+		for(k = 0; k < 3; ++k)
+		{
+			p[k].x = stream->qx[k][i];
+			p[k].y = stream->qy[k][i];
+		}
+	}
+}
+
+static void
+glyph_object_endPoint(glyph_objectStream_t* stream,
+                      glyph_objectSegment_t* seg,
+                      float* _x, float* _y)
+{
+	ASSERT(stream);
+	ASSERT(seg);
+	ASSERT(_x);
+	ASSERT(_y);
+
+	int i = seg->idx;
+	if(seg->type == GLYPH_OBJECT_SEGMENT_CUBIC)
+	{
+		*_x = stream->kx[3][i];
+		*_y = stream->ky[3][i];
+	}
+	else if(seg->type == GLYPH_OBJECT_SEGMENT_CONIC)
+	{
+		*_x = stream->qx[2][i];
+		*_y = stream->qy[2][i];
+	}
+	else
+	{
+		*_x = stream->lx[i];
+		*_y = stream->ly[i];
+	}
+}
+
+// the conics of a glyph are evaluated in batches by the
+// Bezier kernel as the segment stream is walked in order
+// since the conics are stored in segment order
+typedef struct
+{
+	int   steps;
+	int   first;
+	int   count;
+	float x[GLYPH_OBJECT_BATCH_SIZE];
+	float y[GLYPH_OBJECT_BATCH_SIZE];
+} glyph_objectBatch_t;
+
+static void
+glyph_object_initBatch(glyph_objectBatch_t* batch, int steps)
+{
+	ASSERT(batch);
+
+	batch->steps = steps;
+	batch->first = 0;
+	batch->count = 0;
+}
+
+static int
+glyph_object_batchConic(glyph_objectStream_t* stream,
+                        glyph_objectBatch_t* batch,
+                        int i, glyph_stats_t* stats)
+{
+	ASSERT(stream);
+	ASSERT(batch);
+
+	// evaluate the next batch starting at conic i
+	int n = batch->steps + 1;
+	if((i < batch->first) ||
+	   (i >= batch->first + batch->count))
+	{
+		int count = GLYPH_OBJECT_BATCH_SIZE/n;
+		if(count > stream->nq - i)
+		{
+			count = stream->nq - i;
+		}
+
+		glyph_bezier_evaluate(count,
+		                      &stream->qx[0][i], &stream->qy[0][i],
+		                      &stream->qx[1][i], &stream->qy[1][i],
+		                      &stream->qx[2][i], &stream->qy[2][i],
+		                      batch->steps, batch->x, batch->y);
+		batch->first = i;
+		batch->count = count;
+
+		if(stats)
+		{
+			stats->batches += 1;
+			stats->batched += count;
+		}
+	}
+
+	// offset of the samples of conic i
+	return (i - batch->first)*n;
+}
+
+static int
+glyph_parsePoints(glyph_object_t* self, glyph_font_t* font,
+                  glyph_parser_t* parser)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	// parse points directly into the arena
+	float* x    = &font->x[self->p];
+	float* y    = &font->y[self->p];
+	int    np   = self->np;
+	int    size = 0;
+	glyph_parser_expect(parser, '[');
+	while(glyph_parser_accept(parser, ']') == 0)
+	{
+		if(size >= 2*np)
+		{
+			LOGE("invalid size=%i, np=%i", size + 1, np);
+			return 0;
+		}
+
+		float* pf = (size & 1) ? &y[size/2] : &x[size/2];
+		if((glyph_parser_float(parser, pf)  == 0) ||
+		   (glyph_parser_next(parser, ']') == 0))
+		{
+			return 0;
+		}
+
+		++size;
+	}
 
-	int size = cc_list_size(array->list);
 	if(size != (2*np))
 	{
 		LOGE("invalid size=%i, np=%i", size, np);
-		return NULL;
+		return 0;
+	}
+
+	return 1;
+}
+
+static int
+glyph_parseTags(glyph_object_t* self, glyph_font_t* font,
+                glyph_parser_t* parser)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	// parse tags directly into the arena
+	uint8_t* t    = &font->t[self->p];
+	int      np   = self->np;
+	int      size = 0;
+	glyph_parser_expect(parser, '[');
+	while(glyph_parser_accept(parser, ']') == 0)
+	{
+		if(size >= np)
+		{
+			LOGE("invalid size=%i, np=%i", size + 1, np);
+			return 0;
+		}
+
+		int tag = 0;
+		if((glyph_parser_int(parser, &tag)  == 0) ||
+		   (glyph_parser_next(parser, ']') == 0))
+		{
+			return 0;
+		}
+
+		if((tag < 0) || (tag > 2))
+		{
+			LOGE("invalid tag=%i", tag);
+			return 0;
+		}
+		t[size] = (uint8_t) tag;
+
+		++size;
 	}
 
-	cc_vec2f_t* p;
-	p = (cc_vec2f_t*) CALLOC(np, sizeof(cc_vec2f_t));
-	if(p == NULL)
+	if(size != np)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		LOGE("invalid size=%i, np=%i", size, np);
+		return 0;
 	}
 
-	// parse points
-	int idx = 0;
-	cc_listIter_t* iter = cc_list_head(array->list);
-	while(iter)
+	return 1;
+}
+
+static int
+glyph_parseContour(glyph_object_t* self, glyph_font_t* font,
+                   glyph_parser_t* parser)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	// parse contours directly into the arena
+	int32_t* c    = &font->c[self->c];
+	int      nc   = self->nc;
+	int      size = 0;
+	glyph_parser_expect(parser, '[');
+	while(glyph_parser_accept(parser, ']') == 0)
 	{
-		jsmn_val_t* val = (jsmn_val_t*) cc_list_peekIter(iter);
-		if(val->type != JSMN_TYPE_PRIMITIVE)
+		if(size >= nc)
+		{
+			LOGE("invalid size=%i, nc=%i", size + 1, nc);
+			return 0;
+		}
+
+		int end = 0;
+		if((glyph_parser_int(parser, &end)  == 0) ||
+		   (glyph_parser_next(parser, ']') == 0))
 		{
-			LOGE("invalid type=%i", val->type);
-			goto fail_val;
+			return 0;
 		}
-		p[idx].x = strtof(val->data, NULL);
+		c[size] = (int32_t) end;
+
+		++size;
+	}
+
+	if(size != nc)
+	{
+		LOGE("invalid size=%i, nc=%i", size, nc);
+		return 0;
+	}
+
+	return 1;
+}
+
+// the fan kernel sums the area between the 16-step
+// polyline and the polyline of 2^k spans where each span
+// is a fan of triangles anchored at its start point
+// the kernel is specialized for each k by the compiler since
+// k is a constant after inlining
+__attribute__((always_inline))
+static inline float
+glyph_object_fanArea(const cc_vec2f_t* pts, const int k)
+{
+	ASSERT(pts);
 
-		iter = cc_list_next(iter);
+	const int stride = 16 >> k;
 
-		val  = (jsmn_val_t*) cc_list_peekIter(iter);
-		if(val->type != JSMN_TYPE_PRIMITIVE)
+	int   j;
+	int   m;
+	float area = 0.0f;
+	GLYPH_OBJECT_UNROLL
+	for(j = 0; j < 16; j += stride)
+	{
+		GLYPH_OBJECT_UNROLL
+		for(m = j + 1; m < j + stride; ++m)
 		{
-			LOGE("invalid type=%i", val->type);
-			goto fail_val;
+			area += cc_vec2f_triangleArea(&pts[j], &pts[m],
+			                              &pts[m + 1]);
 		}
-		p[idx].y = strtof(val->data, NULL);
+	}
+
+	return area;
+}
+
+static void
+glyph_object_errorPolyline(const float* x, const float* y,
+                           float* _dist,
+                           float* _e1, float* _e2,
+                           float* _e4, float* _e8)
+{
+	ASSERT(x);
+	ASSERT(y);
+	ASSERT(_dist);
+	ASSERT(_e1);
+	ASSERT(_e2);
+	ASSERT(_e4);
+	ASSERT(_e8);
+
+	// measure distance of the 16-step polyline
+	int        i;
+	cc_vec2f_t pts[17];
+	float      dist = 0.0f;
+	for(i = 0; i <= 16; ++i)
+	{
+		pts[i].x = x[i];
+		pts[i].y = y[i];
 
-		iter = cc_list_next(iter);
-		++idx;
+		if(i > 0)
+		{
+			cc_vec2f_t delta;
+			cc_vec2f_subv_copy(&pts[i], &pts[i - 1], &delta);
+			dist += cc_vec2f_mag(&delta);
+		}
 	}
 
-	// success
-	return p;
+	// compute error between each subdivision step
+	// e1:  0----------------16
+	// e2:  0--------8--------16
+	// e4:  0----4----8----C----16
+	// e8:  0--2--4--6--8--A--C--E--16
+	float e1 = glyph_object_fanArea(pts, 0);
+	float e2 = glyph_object_fanArea(pts, 1);
+	float e4 = glyph_object_fanArea(pts, 2);
+	float e8 = glyph_object_fanArea(pts, 3);
+
+	// scale error by 1/dist
+	*_dist = dist;
+	*_e1   = e1/dist;
+	*_e2   = e2/dist;
+	*_e4   = e4/dist;
+	*_e8   = e8/dist;
+}
 
-	// failure
-	fail_val:
-		FREE(p);
-	return NULL;
+static void
+glyph_object_errorSampled(glyph_objectStream_t* stream)
+{
+	ASSERT(stream);
+
+	// the sampled tables of every conic are computed
+	// together from batches of 16-step polylines
+	int                    i;
+	glyph_objectBatch_t    batch;
+	glyph_objectSegment_t* seg = stream->segs;
+	glyph_object_initBatch(&batch, 16);
+	for(i = 0; i < stream->ns; ++i, ++seg)
+	{
+		if((seg->type != GLYPH_OBJECT_SEGMENT_CONIC) ||
+		   (seg->errors & (1 << GLYPH_OBJECT_ERROR_SAMPLED)))
+		{
+			continue;
+		}
+
+		glyph_objectError_t* e;
+		int o = glyph_object_batchConic(stream, &batch,
+		                                seg->idx, NULL);
+		e = &seg->error[GLYPH_OBJECT_ERROR_SAMPLED];
+		glyph_object_errorPolyline(&batch.x[o], &batch.y[o],
+		                           &e->dist, &e->e1, &e->e2,
+		                           &e->e4, &e->e8);
+		seg->errors |= (1 << GLYPH_OBJECT_ERROR_SAMPLED);
+	}
 }
 
-static int*
-glyph_newTags(int np, jsmn_array_t* array)
+static void
+glyph_object_errorCubic(cc_vec2f_t* p0,
+                        cc_vec2f_t* p1,
+                        cc_vec2f_t* p2,
+                        cc_vec2f_t* p3,
+                        float* _dist,
+                        float* _e1, float* _e2,
+                        float* _e4, float* _e8)
 {
-	ASSERT(array);
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+	ASSERT(p3);
+
+	// the closed form does not extend to cubics since the
+	// area cancels across an inflection and the arc length
+	// has no closed form so cubics are always sampled
+	float x[17];
+	float y[17];
+	glyph_bezier_evaluateCubic(p0->x, p0->y, p1->x, p1->y,
+	                           p2->x, p2->y, p3->x, p3->y,
+	                           16, x, y);
+	glyph_object_errorPolyline(x, y, _dist,
+	                           _e1, _e2, _e4, _e8);
+}
 
-	int size = cc_list_size(array->list);
-	if(size != np)
+static float
+glyph_object_arcLength(cc_vec2f_t* p0,
+                       cc_vec2f_t* p1,
+                       cc_vec2f_t* p2)
+{
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+
+	// B'(t) = 2(a*t + b) so the speed is sqrt(A*t^2 + B*t + C)
+	// which integrates to a closed form
+	// https://en.wikipedia.org/wiki/B%C3%A9zier_curve
+	double ax = (double) p0->x - 2.0*p1->x + p2->x;
+	double ay = (double) p0->y - 2.0*p1->y + p2->y;
+	double bx = (double) p1->x - p0->x;
+	double by = (double) p1->y - p0->y;
+	double A  = 4.0*(ax*ax + ay*ay);
+	double B  = 8.0*(ax*bx + ay*by);
+	double C  = 4.0*(bx*bx + by*by);
+
+	// constant speed when P1 is the midpoint of P0 and P2
+	if(A < 1.0e-12)
 	{
-		LOGE("invalid size=%i, np=%i", size, np);
-		return NULL;
+		return (float) sqrt(C);
+	}
+
+	double sabc = 2.0*sqrt(A + B + C);
+	double a2   = sqrt(A);
+	double a32  = 2.0*A*a2;
+	double c2   = 2.0*sqrt(C);
+	double ba   = B/a2;
+	double len  = a32*sabc + a2*B*(sabc - c2);
+
+	// the log term vanishes when the points are collinear
+	double k = 4.0*A*C - B*B;
+	if(k > 1.0e-12*A*C)
+	{
+		len += k*log((2.0*a2 + ba + sabc)/(ba + c2));
+	}
+
+	return (float) (len/(4.0*a32));
+}
+
+static float
+glyph_object_arcLengthCubic(cc_vec2f_t* p0,
+                            cc_vec2f_t* p1,
+                            cc_vec2f_t* p2,
+                            cc_vec2f_t* p3)
+{
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+	ASSERT(p3);
+
+	// the cubic arc length has no closed form so integrate
+	// the speed with 5-point Gauss-Legendre quadrature
+	// B'(t) = 3(s^2(P1 - P0) + 2st(P2 - P1) + t^2(P3 - P2))
+	const float gt[5] =
+	{
+		0.5f - 0.4530899229693320f,
+		0.5f - 0.2692346550528416f,
+		0.5f,
+		0.5f + 0.2692346550528416f,
+		0.5f + 0.4530899229693320f,
+	};
+	const float gw[5] =
+	{
+		0.1184634425280945f,
+		0.2393143352496832f,
+		0.2844444444444444f,
+		0.2393143352496832f,
+		0.1184634425280945f,
+	};
+
+	float ax = p1->x - p0->x;
+	float ay = p1->y - p0->y;
+	float bx = p2->x - p1->x;
+	float by = p2->y - p1->y;
+	float cx = p3->x - p2->x;
+	float cy = p3->y - p2->y;
+
+	int   i;
+	float len = 0.0f;
+	for(i = 0; i < 5; ++i)
+	{
+		float t  = gt[i];
+		float s  = 1.0f - t;
+		float dx = s*s*ax + 2.0f*s*t*bx + t*t*cx;
+		float dy = s*s*ay + 2.0f*s*t*by + t*t*cy;
+		len += gw[i]*sqrtf(dx*dx + dy*dy);
+	}
+
+	return 3.0f*len;
+}
+
+static void
+glyph_object_errorAnalytic(cc_vec2f_t* p0,
+                           cc_vec2f_t* p1,
+                           cc_vec2f_t* p2,
+                           float* _dist,
+                           float* _e1, float* _e2,
+                           float* _e4, float* _e8)
+{
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+	ASSERT(_dist);
+	ASSERT(_e1);
+	ASSERT(_e2);
+	ASSERT(_e4);
+	ASSERT(_e8);
+
+	// The area between a quadratic Bezier curve and its
+	// n-step polyline is 2*A/(3*n^2) where A is the area of
+	// the control triangle. The absolute error relative to
+	// the 16-step polyline is therefore
+	// Eabs(n) = 2*A/3*(1/n^2 - 1/256)
+	// and the average error uses the arc length in place of
+	// the length of the 16-step polyline.
+	float cross = (p1->x - p0->x)*(p2->y - p0->y) -
+	              (p1->y - p0->y)*(p2->x - p0->x);
+	float area  = fabsf(cross)/3.0f;
+	float dist  = glyph_object_arcLength(p0, p1, p2);
+
+	*_dist = dist;
+	*_e1   = area*(1.0f   - 1.0f/256.0f)/dist;
+	*_e2   = area*(0.25f  - 1.0f/256.0f)/dist;
+	*_e4   = area*(0.0625f - 1.0f/256.0f)/dist;
+	*_e8   = area*(1.0f/64.0f - 1.0f/256.0f)/dist;
+}
+
+static glyph_objectError_t*
+glyph_object_segmentError(glyph_objectStream_t* stream,
+                          glyph_objectSegment_t* seg,
+                          int flags)
+{
+	ASSERT(stream);
+	ASSERT(seg);
+
+	int idx = GLYPH_OBJECT_ERROR_SAMPLED;
+	if((seg->type == GLYPH_OBJECT_SEGMENT_CONIC) &&
+	   (flags & GLYPH_OBJECT_FLAG_ANALYTIC))
+	{
+		idx = GLYPH_OBJECT_ERROR_ANALYTIC;
+	}
+
+	glyph_objectError_t* e = &seg->error[idx];
+	if(seg->errors & (1 << idx))
+	{
+		return e;
+	}
+
+	cc_vec2f_t p[4];
+	if(seg->type == GLYPH_OBJECT_SEGMENT_CUBIC)
+	{
+		glyph_object_points(stream, seg, p);
+		glyph_object_errorCubic(&p[0], &p[1], &p[2], &p[3],
+		                        &e->dist, &e->e1, &e->e2,
+		                        &e->e4, &e->e8);
+	}
+	else if(idx == GLYPH_OBJECT_ERROR_ANALYTIC)
+	{
+		glyph_object_points(stream, seg, p);
+		glyph_object_errorAnalytic(&p[0], &p[1], &p[2],
+		                           &e->dist, &e->e1, &e->e2,
+		                           &e->e4, &e->e8);
+	}
+	else
+	{
+		glyph_object_errorSampled(stream);
+		return e;
+	}
+	seg->errors |= (1 << idx);
+
+	return e;
+}
+
+static int
+glyph_object_thresholdSteps(glyph_objectError_t* e,
+                            float threshf, float* _err)
+{
+	ASSERT(e);
+	ASSERT(_err);
+
+	if(e->e1 < threshf)
+	{
+		*_err = e->e1;
+		return 1;
+	}
+	else if(e->e2 < threshf)
+	{
+		*_err = e->e2;
+		return 2;
+	}
+	else if(e->e4 < threshf)
+	{
+		*_err = e->e4;
+		return 4;
+	}
+	else if(e->e8 < threshf)
+	{
+		*_err = e->e8;
+		return 8;
+	}
+
+	*_err = 0.0f;
+	return 16;
+}
+
+static int
+glyph_object_segmentSteps(glyph_objectStream_t* stream,
+                          glyph_objectSegment_t* seg,
+                          int steps, int thresh, int flags)
+{
+	ASSERT(stream);
+	ASSERT(seg);
+
+	// steps of a non-recursive build
+	if(seg->type == GLYPH_OBJECT_SEGMENT_LINE)
+	{
+		return 1;
+	}
+	else if(thresh > 0)
+	{
+		glyph_objectError_t* e;
+		float err;
+		float threshf = ((float) thresh)/(10000.0f);
+		e = glyph_object_segmentError(stream, seg, flags);
+		return glyph_object_thresholdSteps(e, threshf, &err);
+	}
+
+	return steps;
+}
+
+typedef struct
+{
+	cc_vec2f_t p0;
+	cc_vec2f_t p1;
+	cc_vec2f_t p2;
+	float      area;
+	int        depth;
+} glyph_objectSpan_t;
+
+static void
+glyph_object_initSpan(glyph_objectSpan_t* span,
+                      cc_vec2f_t* p0, cc_vec2f_t* p1,
+                      cc_vec2f_t* p2, int depth)
+{
+	ASSERT(span);
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+
+	// the absolute error of the span is the area between
+	// the curve and its chord (see glyph_object_errorAnalytic)
+	float cross = (p1->x - p0->x)*(p2->y - p0->y) -
+	              (p1->y - p0->y)*(p2->x - p0->x);
+
+	span->p0    = *p0;
+	span->p1    = *p1;
+	span->p2    = *p2;
+	span->area  = fabsf(cross)/3.0f;
+	span->depth = depth;
+}
+
+static int
+glyph_object_subdivide(glyph_object_t* self,
+                       glyph_sink_t* sink,
+                       int* _first, float threshf,
+                       glyph_stats_t* stats,
+                       cc_vec2f_t* p0,
+                       cc_vec2f_t* p1,
+                       cc_vec2f_t* p2)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(_first);
+	ASSERT(stats);
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+
+	// spans are stored in curve order
+	glyph_objectSpan_t spans[1 << GLYPH_OBJECT_MAX_DEPTH];
+	int                count = 1;
+	glyph_object_initSpan(&spans[0], p0, p1, p2, 0);
+
+	// refine the span with the largest absolute error until
+	// the average error of the segment is below the threshold
+	// so flat spans are not subdivided with curved spans
+	// collinear and degenerate segments have no error so
+	// they are never split
+	float dist  = glyph_object_arcLength(p0, p1, p2);
+	float limit = threshf*dist;
+	float area  = spans[0].area;
+	while(area > limit)
+	{
+		int i;
+		int best = -1;
+		for(i = 0; i < count; ++i)
+		{
+			if((spans[i].depth < GLYPH_OBJECT_MAX_DEPTH) &&
+			   ((best < 0) || (spans[i].area > spans[best].area)))
+			{
+				best = i;
+			}
+		}
+
+		if(best < 0)
+		{
+			break;
+		}
+
+		// split the span at t=0.5 with de Casteljau
+		glyph_objectSpan_t* span = &spans[best];
+		cc_vec2f_t q0;
+		cc_vec2f_t q2;
+		cc_vec2f_t m;
+		cc_vec2f_t s2 = span->p2;
+		q0.x = 0.5f*(span->p0.x + span->p1.x);
+		q0.y = 0.5f*(span->p0.y + span->p1.y);
+		q2.x = 0.5f*(span->p1.x + span->p2.x);
+		q2.y = 0.5f*(span->p1.y + span->p2.y);
+		m.x  = 0.5f*(q0.x + q2.x);
+		m.y  = 0.5f*(q0.y + q2.y);
+
+		memmove(&spans[best + 2], &spans[best + 1],
+		        (count - best - 1)*sizeof(glyph_objectSpan_t));
+		++count;
+
+		area -= span->area;
+		glyph_object_initSpan(&spans[best + 1], &m, &q2, &s2,
+		                      span->depth + 1);
+		glyph_object_initSpan(span, &span->p0, &q0, &m,
+		                      span->depth + 1);
+		area += spans[best].area + spans[best + 1].area;
+	}
+
+	float x[1 << GLYPH_OBJECT_MAX_DEPTH];
+	float y[1 << GLYPH_OBJECT_MAX_DEPTH];
+	int   i;
+	for(i = 0; i < count; ++i)
+	{
+		x[i] = spans[i].p2.x;
+		y[i] = spans[i].p2.y;
+	}
+
+	if(glyph_sink_points(sink, *_first, count, x, y) == 0)
+	{
+		return 0;
+	}
+
+	stats->points += count;
+	*_first = 0;
+
+	if(dist > 0.0f)
+	{
+		stats->err += area/dist;
+	}
+
+	glyph_stats_segment(stats, count);
+
+	return 1;
+}
+
+typedef struct
+{
+	cc_vec2f_t p0;
+	cc_vec2f_t p1;
+	cc_vec2f_t p2;
+	cc_vec2f_t p3;
+	float      area;
+	int        depth;
+} glyph_objectCubicSpan_t;
+
+static void
+glyph_object_initCubicSpan(glyph_objectCubicSpan_t* span,
+                           cc_vec2f_t* p0, cc_vec2f_t* p1,
+                           cc_vec2f_t* p2, cc_vec2f_t* p3,
+                           int depth)
+{
+	ASSERT(span);
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+	ASSERT(p3);
+
+	// The signed area between a cubic Bezier curve and its
+	// chord is 3/20*(Q1xQ2 + Q1xQ3 + 2*Q2xQ3) where Qi=Pi-P0.
+	// The terms share a sign unless the curve inflects so
+	// the sum of magnitudes is the area of a convex span and
+	// a bound for a span which inflects.
+	float q1x = p1->x - p0->x;
+	float q1y = p1->y - p0->y;
+	float q2x = p2->x - p0->x;
+	float q2y = p2->y - p0->y;
+	float q3x = p3->x - p0->x;
+	float q3y = p3->y - p0->y;
+	float c12 = q1x*q2y - q1y*q2x;
+	float c13 = q1x*q3y - q1y*q3x;
+	float c23 = q2x*q3y - q2y*q3x;
+
+	span->p0    = *p0;
+	span->p1    = *p1;
+	span->p2    = *p2;
+	span->p3    = *p3;
+	span->area  = 0.15f*(fabsf(c12) + fabsf(c13) +
+	                     2.0f*fabsf(c23));
+	span->depth = depth;
+}
+
+static int
+glyph_object_subdivideCubic(glyph_object_t* self,
+                            glyph_sink_t* sink,
+                            int* _first, float threshf,
+                            glyph_stats_t* stats,
+                            cc_vec2f_t* p0,
+                            cc_vec2f_t* p1,
+                            cc_vec2f_t* p2,
+                            cc_vec2f_t* p3)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(_first);
+	ASSERT(stats);
+	ASSERT(p0);
+	ASSERT(p1);
+	ASSERT(p2);
+	ASSERT(p3);
+
+	// see glyph_object_subdivide
+	glyph_objectCubicSpan_t spans[1 << GLYPH_OBJECT_MAX_DEPTH];
+	int                     count = 1;
+	glyph_object_initCubicSpan(&spans[0], p0, p1, p2, p3, 0);
+
+	float dist  = glyph_object_arcLengthCubic(p0, p1, p2, p3);
+	float limit = threshf*dist;
+	float area  = spans[0].area;
+	while(area > limit)
+	{
+		int i;
+		int best = -1;
+		for(i = 0; i < count; ++i)
+		{
+			if((spans[i].depth < GLYPH_OBJECT_MAX_DEPTH) &&
+			   ((best < 0) || (spans[i].area > spans[best].area)))
+			{
+				best = i;
+			}
+		}
+
+		if(best < 0)
+		{
+			break;
+		}
+
+		// split the span at t=0.5 with de Casteljau
+		glyph_objectCubicSpan_t* span = &spans[best];
+		cc_vec2f_t q0;
+		cc_vec2f_t q1;
+		cc_vec2f_t q2;
+		cc_vec2f_t r0;
+		cc_vec2f_t r1;
+		cc_vec2f_t m;
+		cc_vec2f_t s3 = span->p3;
+		q0.x = 0.5f*(span->p0.x + span->p1.x);
+		q0.y = 0.5f*(span->p0.y + span->p1.y);
+		q1.x = 0.5f*(span->p1.x + span->p2.x);
+		q1.y = 0.5f*(span->p1.y + span->p2.y);
+		q2.x = 0.5f*(span->p2.x + span->p3.x);
+		q2.y = 0.5f*(span->p2.y + span->p3.y);
+		r0.x = 0.5f*(q0.x + q1.x);
+		r0.y = 0.5f*(q0.y + q1.y);
+		r1.x = 0.5f*(q1.x + q2.x);
+		r1.y = 0.5f*(q1.y + q2.y);
+		m.x  = 0.5f*(r0.x + r1.x);
+		m.y  = 0.5f*(r0.y + r1.y);
+
+		memmove(&spans[best + 2], &spans[best + 1],
+		        (count - best - 1)*sizeof(glyph_objectCubicSpan_t));
+		++count;
+
+		area -= span->area;
+		glyph_object_initCubicSpan(&spans[best + 1], &m, &r1,
+		                           &q2, &s3, span->depth + 1);
+		glyph_object_initCubicSpan(span, &span->p0, &q0, &r0,
+		                           &m, span->depth + 1);
+		area += spans[best].area + spans[best + 1].area;
+	}
+
+	float x[1 << GLYPH_OBJECT_MAX_DEPTH];
+	float y[1 << GLYPH_OBJECT_MAX_DEPTH];
+	int   i;
+	for(i = 0; i < count; ++i)
+	{
+		x[i] = spans[i].p3.x;
+		y[i] = spans[i].p3.y;
+	}
+
+	if(glyph_sink_points(sink, *_first, count, x, y) == 0)
+	{
+		return 0;
+	}
+
+	stats->points += count;
+	*_first = 0;
+
+	if(dist > 0.0f)
+	{
+		stats->err += area/dist;
+	}
+
+	glyph_stats_segment(stats, count);
+
+	return 1;
+}
+
+static int
+glyph_object_interpolate(glyph_object_t* self,
+                         glyph_sink_t* sink,
+                         int* _first,
+                         int steps, int thresh, int flags,
+                         glyph_stats_t* stats,
+                         glyph_objectBatch_t* batch,
+                         glyph_objectSegment_t* seg)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(_first);
+	ASSERT(stats);
+	ASSERT(batch);
+	ASSERT(seg);
+
+	cc_vec2f_t p[3];
+	glyph_object_points(self->stream, seg, p);
+
+	cc_vec2f_t* p0 = &p[0];
+	cc_vec2f_t* p1 = &p[1];
+	cc_vec2f_t* p2 = &p[2];
+
+	// optionally perform recursive subdivision which is
+	// limited by GLYPH_OBJECT_MAX_DEPTH rather than steps
+	if((thresh > 0) && (flags & GLYPH_OBJECT_FLAG_RECURSIVE))
+	{
+		float threshf = ((float) thresh)/(10000.0f);
+		return glyph_object_subdivide(self, sink, _first, threshf,
+		                              stats, p0, p1, p2);
+	}
+	else if(thresh > 0)
+	{
+		// threshold steps
+		glyph_objectError_t* e;
+		float err;
+		float threshf = ((float) thresh)/(10000.0f);
+		e     = glyph_object_segmentError(self->stream, seg,
+		                                  flags);
+		steps = glyph_object_thresholdSteps(e, threshf, &err);
+
+		stats->err += err;
+
+		LOGD("steps=%i, dist=%f, err=%f, e: %f, %f, %f, %f",
+		     steps, e->dist, err, e->e1, e->e2, e->e4, e->e8);
+	}
+
+	// perform subdivision
+	glyph_stats_segment(stats, steps);
+
+	float x[GLYPH_OBJECT_MAX_STEPS + 1];
+	float y[GLYPH_OBJECT_MAX_STEPS + 1];
+	if(flags & GLYPH_OBJECT_FLAG_FORWARD)
+	{
+		// samples are written for (p0,p2]
+		glyph_bezier_forward(p0->x, p0->y, p1->x, p1->y,
+		                     p2->x, p2->y, steps,
+		                     &x[1], &y[1]);
+	}
+	else if(steps > 0)
+	{
+		// the batch is evaluated with a multiple of the steps
+		// and the power of two tables of the kernels are
+		// subsamples of each other so the samples are
+		// identical to evaluating the conic with steps
+		int i;
+		int stride = batch->steps/steps;
+		int o      = glyph_object_batchConic(self->stream, batch,
+		                                     seg->idx, stats);
+		for(i = 0; i <= steps; ++i)
+		{
+			x[i] = batch->x[o + i*stride];
+			y[i] = batch->y[o + i*stride];
+		}
+	}
+
+	if(steps <= 0)
+	{
+		return 1;
+	}
+
+	if(glyph_sink_points(sink, *_first, steps,
+	                     &x[1], &y[1]) == 0)
+	{
+		return 0;
+	}
+
+	stats->points += steps;
+	*_first = 0;
+
+	return 1;
+}
+
+static int
+glyph_object_interpolateCubic(glyph_object_t* self,
+                              glyph_sink_t* sink,
+                              int* _first,
+                              int steps, int thresh, int flags,
+                              glyph_stats_t* stats,
+                              glyph_objectSegment_t* seg)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(_first);
+	ASSERT(stats);
+	ASSERT(seg);
+
+	cc_vec2f_t p[4];
+	glyph_object_points(self->stream, seg, p);
+
+	cc_vec2f_t* p0 = &p[0];
+	cc_vec2f_t* p1 = &p[1];
+	cc_vec2f_t* p2 = &p[2];
+	cc_vec2f_t* p3 = &p[3];
+
+	// see glyph_object_interpolate
+	if((thresh > 0) && (flags & GLYPH_OBJECT_FLAG_RECURSIVE))
+	{
+		float threshf = ((float) thresh)/(10000.0f);
+		return glyph_object_subdivideCubic(self, sink, _first,
+		                                   threshf, stats,
+		                                   p0, p1, p2, p3);
+	}
+	else if(thresh > 0)
+	{
+		// threshold steps
+		glyph_objectError_t* e;
+		float err;
+		float threshf = ((float) thresh)/(10000.0f);
+		e     = glyph_object_segmentError(self->stream, seg,
+		                                  flags);
+		steps = glyph_object_thresholdSteps(e, threshf, &err);
+
+		stats->err += err;
+	}
+
+	// perform subdivision
+	glyph_stats_segment(stats, steps);
+
+	float x[GLYPH_OBJECT_MAX_STEPS + 1];
+	float y[GLYPH_OBJECT_MAX_STEPS + 1];
+	if(flags & GLYPH_OBJECT_FLAG_FORWARD)
+	{
+		// samples are written for (p0,p3]
+		glyph_bezier_forwardCubic(p0->x, p0->y, p1->x, p1->y,
+		                          p2->x, p2->y, p3->x, p3->y,
+		                          steps, &x[1], &y[1]);
+	}
+	else
+	{
+		glyph_bezier_evaluateCubic(p0->x, p0->y, p1->x, p1->y,
+		                           p2->x, p2->y, p3->x, p3->y,
+		                           steps, x, y);
+	}
+
+	if(steps <= 0)
+	{
+		return 1;
+	}
+
+	if(glyph_sink_points(sink, *_first, steps,
+	                     &x[1], &y[1]) == 0)
+	{
+		return 0;
+	}
+
+	stats->points += steps;
+	*_first = 0;
+
+	return 1;
+}
+
+static int
+glyph_object_parseKeys(glyph_object_t* self,
+                       glyph_font_t* font,
+                       glyph_parser_t* parser,
+                       int lazy)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	int has_name = 0;
+	int has_p    = 0;
+	int has_t    = 0;
+	int has_c    = 0;
+
+	// keys are handled in the order they are encountered
+	// and duplicate keys are rejected
+	while(glyph_parser_accept(parser, '}') == 0)
+	{
+		const char* key;
+		size_t      len;
+		if((glyph_parser_string(parser, &key, &len) == 0) ||
+		   (glyph_parser_expect(parser, ':')        == 0))
+		{
+			return 0;
+		}
+
+		int type = glyph_parser_type(parser);
+		if((len == 4) && (strncmp(key, "name", 4) == 0) &&
+		   (type == GLYPH_PARSER_TYPE_STRING))
+		{
+			const char* name;
+			size_t      size;
+			if(glyph_parser_string(parser, &name, &size) == 0)
+			{
+				return 0;
+			}
+
+			if(has_name)
+			{
+				LOGE("invalid %.*s", (int) size, name);
+				return 0;
+			}
+
+			// the name was stored by glyph_object_scan
+			if((lazy == 0) &&
+			   (glyph_font_allocName(font, name, (uint32_t) size,
+			                         &self->name) == 0))
+			{
+				return 0;
+			}
+			has_name = 1;
+		}
+		else if((len == 1) && (key[0] == 'w') &&
+		        (type == GLYPH_PARSER_TYPE_PRIMITIVE))
+		{
+			if(self->w != -1.0f)
+			{
+				LOGE("invalid w");
+				return 0;
+			}
+
+			if(glyph_parser_float(parser, &self->w) == 0)
+			{
+				return 0;
+			}
+		}
+		else if((len == 1) && (key[0] == 'h') &&
+		        (type == GLYPH_PARSER_TYPE_PRIMITIVE))
+		{
+			if(self->h != -1.0f)
+			{
+				LOGE("invalid h");
+				return 0;
+			}
+
+			if(glyph_parser_float(parser, &self->h) == 0)
+			{
+				return 0;
+			}
+		}
+		else if((len == 2) && (strncmp(key, "np", 2) == 0) &&
+		        (type == GLYPH_PARSER_TYPE_PRIMITIVE))
+		{
+			if(self->np != -1)
+			{
+				LOGE("invalid np");
+				return 0;
+			}
+
+			if(glyph_parser_int(parser, &self->np) == 0)
+			{
+				return 0;
+			}
+
+			if(self->np < 0)
+			{
+				LOGE("invalid np=%i", self->np);
+				return 0;
+			}
+
+			self->p = glyph_font_allocPoints(font, self->np);
+			if(self->p < 0)
+			{
+				return 0;
+			}
+		}
+		else if((len == 1) && (key[0] == 'p') &&
+		        (type == GLYPH_PARSER_TYPE_ARRAY))
+		{
+			if((self->np < 0) || has_p)
+			{
+				LOGE("invalid np=%i, has_p=%i",
+				     self->np, has_p);
+				return 0;
+			}
+
+			if(glyph_parsePoints(self, font, parser) == 0)
+			{
+				return 0;
+			}
+			has_p = 1;
+		}
+		else if((len == 1) && (key[0] == 't') &&
+		        (type == GLYPH_PARSER_TYPE_ARRAY))
+		{
+			if((self->np < 0) || has_t)
+			{
+				LOGE("invalid np=%i, has_t=%i",
+				     self->np, has_t);
+				return 0;
+			}
+
+			if(glyph_parseTags(self, font, parser) == 0)
+			{
+				return 0;
+			}
+			has_t = 1;
+		}
+		else if((len == 2) && (strncmp(key, "nc", 2) == 0) &&
+		        (type == GLYPH_PARSER_TYPE_PRIMITIVE))
+		{
+			if(self->nc != -1)
+			{
+				LOGE("invalid nc");
+				return 0;
+			}
+
+			if(glyph_parser_int(parser, &self->nc) == 0)
+			{
+				return 0;
+			}
+
+			if(self->nc < 0)
+			{
+				LOGE("invalid nc=%i", self->nc);
+				return 0;
+			}
+
+			self->c = glyph_font_allocContours(font, self->nc);
+			if(self->c < 0)
+			{
+				return 0;
+			}
+		}
+		else if((len == 1) && (key[0] == 'c') &&
+		        (type == GLYPH_PARSER_TYPE_ARRAY))
+		{
+			if((self->nc < 0) || has_c)
+			{
+				LOGE("invalid nc=%i, has_c=%i",
+				     self->nc, has_c);
+				return 0;
+			}
+
+			if(glyph_parseContour(self, font, parser) == 0)
+			{
+				return 0;
+			}
+			has_c = 1;
+		}
+		else if(glyph_parser_skip(parser) == 0)
+		{
+			return 0;
+		}
+
+		if(glyph_parser_next(parser, '}') == 0)
+		{
+			return 0;
+		}
+	}
+
+	// validate data
+	if((has_name == 0)   ||
+	   (self->w  <  0.0f) ||
+	   (self->h  <  0.0f) ||
+	   (self->np <  0)    ||
+	   (self->nc <  0)    ||
+	   (has_p    == 0)    ||
+	   (has_t    == 0)    ||
+	   (has_c    == 0))
+	{
+		LOGE("invalid name=%s, w=%f, h=%f, np=%i, nc=%i, has_p=%i, has_t=%i, has_c=%i",
+		     has_name ? glyph_object_name(self) : "NULL",
+		     self->w, self->h, self->np, self->nc,
+		     has_p, has_t, has_c);
+		return 0;
+	}
+
+	self->code = glyph_object_code(glyph_object_name(self));
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int glyph_object_parse(glyph_object_t* self,
+                       glyph_font_t* font,
+                       glyph_parser_t* parser)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	if(glyph_parser_expect(parser, '{') == 0)
+	{
+		return 0;
+	}
+
+	// initialize state
+	memset((void*) self, 0, sizeof(glyph_object_t));
+	self->font = font;
+	self->w    = -1.0f;
+	self->h    = -1.0f;
+	self->np   = -1;
+	self->nc   = -1;
+
+	return glyph_object_parseKeys(self, font, parser, 0);
+}
+
+int glyph_object_scan(glyph_object_t* self,
+                      glyph_font_t* font,
+                      glyph_parser_t* parser)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(parser);
+
+	memset((void*) self, 0, sizeof(glyph_object_t));
+	self->font = font;
+
+	// only the name is decoded and the remaining keys are
+	// deferred until glyph_object_decode
+	glyph_parser_peek(parser);
+	size_t offset = parser->pos;
+	if(glyph_parser_expect(parser, '{') == 0)
+	{
+		return 0;
+	}
+
+	int has_name = 0;
+	while(glyph_parser_accept(parser, '}') == 0)
+	{
+		const char* key;
+		size_t      len;
+		if((glyph_parser_string(parser, &key, &len) == 0) ||
+		   (glyph_parser_expect(parser, ':')        == 0))
+		{
+			return 0;
+		}
+
+		if((len == 4) && (strncmp(key, "name", 4) == 0) &&
+		   (glyph_parser_type(parser) == GLYPH_PARSER_TYPE_STRING))
+		{
+			const char* name;
+			size_t      size;
+			if(glyph_parser_string(parser, &name, &size) == 0)
+			{
+				return 0;
+			}
+
+			if(has_name)
+			{
+				LOGE("invalid %.*s", (int) size, name);
+				return 0;
+			}
+
+			if(glyph_font_allocName(font, name, (uint32_t) size,
+			                        &self->name) == 0)
+			{
+				return 0;
+			}
+			has_name = 1;
+		}
+		else if(glyph_parser_skipFast(parser) == 0)
+		{
+			return 0;
+		}
+
+		if(glyph_parser_next(parser, '}') == 0)
+		{
+			return 0;
+		}
+	}
+
+	if(has_name == 0)
+	{
+		LOGE("invalid offset=%i", (int) offset);
+		return 0;
+	}
+
+	self->code   = glyph_object_code(glyph_object_name(self));
+	self->lazy   = 1;
+	self->offset = offset;
+	self->size   = parser->pos - offset;
+
+	return 1;
+}
+
+int glyph_object_decode(glyph_object_t* self,
+                        const char* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	if(self->lazy == 0)
+	{
+		return 1;
+	}
+	else if(self->lazy == GLYPH_OBJECT_LAZY_FAILED)
+	{
+		return 0;
+	}
+
+	glyph_parser_t parser;
+	glyph_parser_init(&parser, &data[self->offset], self->size);
+	if(glyph_parser_expect(&parser, '{') == 0)
+	{
+		self->lazy = GLYPH_OBJECT_LAZY_FAILED;
+		return 0;
+	}
+
+	self->w    = -1.0f;
+	self->h    = -1.0f;
+	self->np   = -1;
+	self->nc   = -1;
+	self->lazy = 0;
+	if(glyph_object_parseKeys(self, self->font, &parser, 1) == 0)
+	{
+		// the glyph remains undecoded and the decode is not
+		// attempted again
+		self->np   = 0;
+		self->nc   = 0;
+		self->lazy = GLYPH_OBJECT_LAZY_FAILED;
+		return 0;
+	}
+
+	return 1;
+}
+
+void glyph_object_initPack(glyph_object_t* self,
+                           glyph_font_t* font,
+                           glyph_pack_t* pack,
+                           uint32_t idx)
+{
+	ASSERT(self);
+	ASSERT(font);
+	ASSERT(pack);
+	ASSERT(idx < glyph_pack_count(pack));
+
+	const glyph_packIndex_t* index = &pack->index[idx];
+
+	memset((void*) self, 0, sizeof(glyph_object_t));
+	self->font = font;
+	self->name = index->name;
+	self->code = index->code;
+	self->w    = index->w;
+	self->h    = index->h;
+	self->np   = (int) index->np;
+	self->p    = (int) index->p;
+	self->nc   = (int) index->nc;
+	self->c    = (int) index->c;
+}
+
+void glyph_object_finish(glyph_object_t* self)
+{
+	ASSERT(self);
+
+	FREE(self->stream);
+	self->stream = NULL;
+}
+
+const char* glyph_object_name(glyph_object_t* self)
+{
+	ASSERT(self);
+
+	return &self->font->names[self->name];
+}
+
+uint32_t glyph_object_code(const char* name)
+{
+	ASSERT(name);
+
+	// font-outline names glyphs by their code point
+	// e.g. ascii-0x67
+	const char* hex = strstr(name, "-0x");
+	if(hex == NULL)
+	{
+		return GLYPH_PACK_CODE_NONE;
+	}
+
+	char*         end  = NULL;
+	unsigned long code = strtoul(&hex[3], &end, 16);
+	if((end == &hex[3]) || (*end != '\0') || (code > 0x10FFFF))
+	{
+		return GLYPH_PACK_CODE_NONE;
+	}
+
+	return (uint32_t) code;
+}
+
+// segments are decomposed into a temporary AoS array
+// before they are packed into the stream
+typedef struct
+{
+	int        type;
+	int        first;
+	int        on;
+	cc_vec2f_t p[4];
+} glyph_objectCompile_t;
+
+static int
+glyph_object_addSegment(glyph_object_t* self,
+                        glyph_objectCompile_t* segs,
+                        int* _ns, int type,
+                        int first, int on,
+                        cc_vec2f_t* p0, cc_vec2f_t* p1,
+                        cc_vec2f_t* p2, cc_vec2f_t* p3)
+{
+	ASSERT(self);
+	ASSERT(segs);
+	ASSERT(_ns);
+	ASSERT(p0);
+	ASSERT(p1);
+
+	// each point produces at most one segment
+	if(*_ns >= self->np)
+	{
+		LOGE("invalid ns=%i, np=%i", *_ns, self->np);
+		return 0;
 	}
 
-	int* t;
-	t = (int*) CALLOC(np, sizeof(int));
-	if(t == NULL)
+	glyph_objectCompile_t* seg = &segs[*_ns];
+	seg->type  = type;
+	seg->first = first;
+	seg->on    = on;
+	seg->p[0]  = *p0;
+	seg->p[1]  = *p1;
+	if(p2)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		seg->p[2] = *p2;
 	}
-
-	// parse tags
-	int idx = 0;
-	cc_listIter_t* iter = cc_list_head(array->list);
-	while(iter)
+	if(p3)
 	{
-		jsmn_val_t* val = (jsmn_val_t*) cc_list_peekIter(iter);
-		if(val->type != JSMN_TYPE_PRIMITIVE)
-		{
-			LOGE("invalid type=%i", val->type);
-			goto fail_val;
-		}
-		t[idx] = (int) strtol(val->data, NULL, 0);
-
-		iter = cc_list_next(iter);
-		++idx;
+		seg->p[3] = *p3;
 	}
+	++(*_ns);
 
-	// success
-	return t;
-
-	// failure
-	fail_val:
-		FREE(t);
-	return NULL;
+	return 1;
 }
 
-static int*
-glyph_newContour(int nc, jsmn_array_t* array)
+static int
+glyph_object_pack(glyph_object_t* self,
+                  glyph_objectCompile_t* segs, int ns)
 {
-	ASSERT(array);
+	ASSERT(self);
+	ASSERT(segs);
 
-	int size = cc_list_size(array->list);
-	if(size != nc)
+	int i;
+	int nl = 0;
+	int nq = 0;
+	int nk = 0;
+	for(i = 0; i < ns; ++i)
 	{
-		LOGE("invalid size=%i, nc=%i", size, nc);
-		return NULL;
+		if(segs[i].type == GLYPH_OBJECT_SEGMENT_CUBIC)
+		{
+			++nk;
+		}
+		else if(segs[i].type == GLYPH_OBJECT_SEGMENT_CONIC)
+		{
+			++nq;
+		}
+		else
+		{
+			++nl;
+		}
+	}
+
+	// the stream, segments and control point arrays share
+	// a single allocation
+	size_t size = sizeof(glyph_objectStream_t) +
+	              ns*sizeof(glyph_objectSegment_t) +
+	              (2*nl + 6*nq + 8*nk)*sizeof(float);
+
+	glyph_objectStream_t* stream;
+	stream = (glyph_objectStream_t*) MALLOC(size);
+	if(stream == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
 	}
 
-	int* c;
-	c = (int*) CALLOC(nc, sizeof(int));
-	if(c == NULL)
+	stream->ns   = ns;
+	stream->segs = (glyph_objectSegment_t*) &stream[1];
+	stream->nl   = nl;
+	stream->nq   = nq;
+	stream->nk   = nk;
+
+	int    k;
+	float* f = (float*) &stream->segs[ns];
+	stream->lx = f;
+	stream->ly = f + nl;
+	f += 2*nl;
+	for(k = 0; k < 3; ++k)
+	{
+		stream->qx[k] = f;
+		stream->qy[k] = f + nq;
+		f += 2*nq;
+	}
+	for(k = 0; k < 4; ++k)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		stream->kx[k] = f;
+		stream->ky[k] = f + nk;
+		f += 2*nk;
 	}
 
-	// parse contours
-	int idx = 0;
-	cc_listIter_t* iter = cc_list_head(array->list);
-	while(iter)
+	nl = 0;
+	nq = 0;
+	nk = 0;
+	for(i = 0; i < ns; ++i)
 	{
-		jsmn_val_t* val = (jsmn_val_t*) cc_list_peekIter(iter);
-		if(val->type != JSMN_TYPE_PRIMITIVE)
+		glyph_objectCompile_t* src = &segs[i];
+		glyph_objectSegment_t* seg = &stream->segs[i];
+		seg->type   = src->type;
+		seg->first  = src->first;
+		seg->on     = src->on;
+		seg->errors = 0;
+		if(src->type == GLYPH_OBJECT_SEGMENT_CUBIC)
 		{
-			LOGE("invalid type=%i", val->type);
-			goto fail_val;
+			seg->idx = nk++;
+			for(k = 0; k < 4; ++k)
+			{
+				stream->kx[k][seg->idx] = src->p[k].x;
+				stream->ky[k][seg->idx] = src->p[k].y;
+			}
+		}
+		else if(src->type == GLYPH_OBJECT_SEGMENT_CONIC)
+		{
+			seg->idx = nq++;
+			for(k = 0; k < 3; ++k)
+			{
+				stream->qx[k][seg->idx] = src->p[k].x;
+				stream->qy[k][seg->idx] = src->p[k].y;
+			}
+		}
+		else
+		{
+			seg->idx = nl++;
+			stream->lx[seg->idx] = src->p[1].x;
+			stream->ly[seg->idx] = src->p[1].y;
 		}
-		c[idx] = (int) strtol(val->data, NULL, 0);
-
-		iter = cc_list_next(iter);
-		++idx;
 	}
 
-	// success
-	return c;
+	self->stream = stream;
 
-	// failure
-	fail_val:
-		FREE(c);
-	return NULL;
+	return 1;
 }
 
-/***********************************************************
-* public                                                   *
-***********************************************************/
-
-glyph_object_t*
-glyph_object_new(jsmn_object_t* obj)
+static int
+glyph_object_compile(glyph_object_t* self)
 {
-	ASSERT(obj);
+	ASSERT(self);
 
-	glyph_object_t* self;
-	self = (glyph_object_t*)
-	       CALLOC(1, sizeof(glyph_object_t));
-	if(self == NULL)
+	// outline arrays in the font arena
+	glyph_font_t*  font = self->font;
+	const float*   px   = &font->x[self->p];
+	const float*   py   = &font->y[self->p];
+	const uint8_t* pt   = &font->t[self->p];
+	const int32_t* pc   = &font->c[self->c];
+
+	int                    ns = 0;
+	glyph_objectCompile_t* segs;
+	segs = (glyph_objectCompile_t*)
+	       MALLOC(self->np*sizeof(glyph_objectCompile_t));
+	if(segs == NULL)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		LOGE("MALLOC failed");
+		return 0;
 	}
 
-	// initialize state
-	self->w  = -1.0f;
-	self->h  = -1.0f;
-	self->np = -1;
-	self->nc = -1;
-
-	cc_listIter_t* iter = cc_list_head(obj->list);
-	while(iter)
+	// The following rules are applied to decompose the
+	// contour's points into segments and arcs:
+	// 1) Two successive ON points indicate a line
+	//    segment joining them.
+	// 2) One conic OFF point between two ON points
+	//    indicates a conic Bezier arc, the OFF point
+	//    being the control point, and the ON ones the
+	//    start and end points.
+	// 3) Two successive conic OFF points force the rasterizer
+	//    to create a virtual ON point inbetween, at their
+	//    exact middle.
+	// 4) The last point in a contour uses the first as an end
+	//    point to create a closed contour.
+	// 5) The first point in a contour can be a conic OFF
+	//    point itself. In that case, use the last point of
+	//    the contour as the contour's starting point. If the
+	//    last point is a conic OFF point itself, start the
+	//    contour with the virtual ON point between the last
+	//    and first point of the contour.
+	// 6) Two successive cubic OFF points between two ON
+	//    points indicate a cubic Bezier arc. Cubic OFF
+	//    points must occur in pairs and may not be mixed
+	//    with conic OFF points.
+	// https://freetype.org/freetype2/docs/glyphs/glyphs-6.html
+
+	int c;
+	int p;
+	int p0;
+	int p1;
+	int p2;
+	int p3;
+	int t0;
+	int t1;
+	int t2;
+	int t3;
+	int start = 0;
+	int end   = 0;
+	int first = 1;
+	cc_vec2f_t  pp0;
+	cc_vec2f_t  pp1;
+	cc_vec2f_t  pp2;
+	cc_vec2f_t  pp3;
+	cc_vec2f_t  ppi;
+	cc_vec2f_t  ppj;
+	for(c = 0; c < self->nc; ++c)
 	{
-		jsmn_keyval_t* kv;
-		kv = (jsmn_keyval_t*) cc_list_peekIter(iter);
+		first = 1;
+		end   = pc[c];
 
-		if((strcmp(kv->key, "name") == 0) &&
-		   (kv->val->type == JSMN_TYPE_STRING))
+		for(p = start; p <= end; ++p)
 		{
-			if(self->name != NULL)
+			p0  = ((p - 1) < start) ? end : p - 1;
+			p1  = p;
+			p2  = ((p + 1) > end) ? start : p + 1;
+			pp0.x = px[p0];
+			pp0.y = py[p0];
+			pp1.x = px[p1];
+			pp1.y = py[p1];
+			pp2.x = px[p2];
+			pp2.y = py[p2];
+			t0     = pt[p0];
+			t1     = pt[p1];
+			t2     = pt[p2];
+
+			// apply contour rules
+			// 000 - interpolate (pi,pj]
+			// 001 - interpolate (pi,p2]
+			// 01X - skip
+			// 100 - interpolate (p0,pj]
+			// 101 - interpolate (p0,p2]
+			// 11X - straight line [p2]
+			// 122 - interpolate (p0,p3]
+			// 22X - skip
+			// 21X - skip
+			if((t0 == GLYPH_OBJECT_TAG_CUBIC) &&
+			   (t1 == GLYPH_OBJECT_TAG_CUBIC))
 			{
-				LOGE("invalid %s", kv->val->data);
-				goto fail_glyph;
+				// skip
+				continue;
 			}
-
-			size_t len = strlen(kv->val->data) + 1;
-			self->name = CALLOC(len, sizeof(char));
-			if(self->name == NULL)
+			else if(t1 == GLYPH_OBJECT_TAG_CUBIC)
 			{
-				LOGE("CALLOC failed");
-				goto fail_glyph;
-			}
+				p3    = ((p2 + 1) > end) ? start : p2 + 1;
+				pp3.x = px[p3];
+				pp3.y = py[p3];
+				t3    = pt[p3];
+				if((t0 != GLYPH_OBJECT_TAG_ON)    ||
+				   (t2 != GLYPH_OBJECT_TAG_CUBIC) ||
+				   (t3 != GLYPH_OBJECT_TAG_ON))
+				{
+					LOGE("invalid cubic %s: p=%i",
+					     glyph_object_name(self), p);
+					goto fail_segment;
+				}
 
-			snprintf(self->name, len, "%s", kv->val->data);
-		}
-		else if((strcmp(kv->key, "w") == 0) &&
-		        (kv->val->type == JSMN_TYPE_PRIMITIVE))
-		{
-			if(self->w != -1.0f)
-			{
-				LOGE("invalid %s", kv->val->data);
-				goto fail_glyph;
+				// interpolate contour between p0 and p3
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_CUBIC,
+				                           first, 1, &pp0, &pp1,
+				                           &pp2, &pp3) == 0)
+				{
+					goto fail_segment;
+				}
 			}
-
-			self->w = strtof(kv->val->data, NULL);
-		}
-		else if((strcmp(kv->key, "h") == 0) &&
-		        (kv->val->type == JSMN_TYPE_PRIMITIVE))
-		{
-			if(self->h != -1.0f)
+			else if(t0 == GLYPH_OBJECT_TAG_CUBIC)
 			{
-				LOGE("invalid %s", kv->val->data);
-				goto fail_glyph;
+				// skip since the arc ends at p1
+				if(t1 != GLYPH_OBJECT_TAG_ON)
+				{
+					LOGE("invalid cubic %s: p=%i",
+					     glyph_object_name(self), p);
+					goto fail_segment;
+				}
+				continue;
 			}
-
-			self->h = strtof(kv->val->data, NULL);
-		}
-		else if((strcmp(kv->key, "np") == 0) &&
-		        (kv->val->type == JSMN_TYPE_PRIMITIVE))
-		{
-			if(self->np != -1)
+			else if((t1 == GLYPH_OBJECT_TAG_CONIC) &&
+			        (t2 == GLYPH_OBJECT_TAG_CUBIC))
 			{
-				LOGE("invalid %s", kv->val->data);
-				goto fail_glyph;
+				LOGE("invalid conic %s: p=%i",
+				     glyph_object_name(self), p);
+				goto fail_segment;
 			}
-
-			self->np = (int) strtol(kv->val->data, NULL, 0);
-		}
-		else if((strcmp(kv->key, "p") == 0) &&
-		        (kv->val->type == JSMN_TYPE_ARRAY))
-		{
-			if((self->np < 0) || (self->p != NULL))
+			else if((t0 == 0) && (t1 == 0) && (t2 == 0))
 			{
-				LOGE("invalid np=%i, p=%p",
-				     self->np, self->p);
-				goto fail_glyph;
+				// add virtual point between p0 and p1
+				ppi.x = pp0.x + (pp1.x - pp0.x)/2.0f;
+				ppi.y = pp0.y + (pp1.y - pp0.y)/2.0f;
+
+				// add virtual point between p1 and p2
+				ppj.x = pp1.x + (pp2.x - pp1.x)/2.0f;
+				ppj.y = pp1.y + (pp2.y - pp1.y)/2.0f;
+
+				// interpolate contour between pi and pj
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_CONIC,
+				                           first, 0, &ppi, &pp1,
+				                           &ppj, NULL) == 0)
+				{
+					goto fail_segment;
+				}
 			}
-
-			self->p = glyph_newPoints(self->np, kv->val->array);
-			if(self->p == NULL)
+			else if((t0 == 0) && (t1 == 0) && t2)
 			{
-				goto fail_glyph;
+				// add virtual point between p0 and p1
+				ppi.x = pp0.x + (pp1.x - pp0.x)/2.0f;
+				ppi.y = pp0.y + (pp1.y - pp0.y)/2.0f;
+
+				// interpolate contour between pi and p2
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_CONIC,
+				                           first, 1, &ppi, &pp1,
+				                           &pp2, NULL) == 0)
+				{
+					goto fail_segment;
+				}
 			}
-		}
-		else if((strcmp(kv->key, "t") == 0) &&
-		        (kv->val->type == JSMN_TYPE_ARRAY))
-		{
-			if((self->np < 0) || (self->t != NULL))
+			else if((t0 == 0) && t1)
 			{
-				LOGE("invalid np=%i, t=%p",
-				     self->np, self->t);
-				goto fail_glyph;
+				// skip
+				continue;
 			}
-
-			self->t = glyph_newTags(self->np, kv->val->array);
-			if(self->t == NULL)
+			else if(t0 && (t1 == 0) && (t2 == 0))
 			{
-				goto fail_glyph;
+				// add virtual point between p1 and p2
+				ppj.x = pp1.x + (pp2.x - pp1.x)/2.0f;
+				ppj.y = pp1.y + (pp2.y - pp1.y)/2.0f;
+
+				// interpolate contour between p0 and pj
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_CONIC,
+				                           first, 0, &pp0, &pp1,
+				                           &ppj, NULL) == 0)
+				{
+					goto fail_segment;
+				}
 			}
-		}
-		else if((strcmp(kv->key, "nc") == 0) &&
-		        (kv->val->type == JSMN_TYPE_PRIMITIVE))
-		{
-			if(self->nc != -1)
+			else if(t0 && (t1 == 0) && t2)
 			{
-				LOGE("invalid %s", kv->val->data);
-				goto fail_glyph;
+				// interpolate contour between p0 and p2
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_CONIC,
+				                           first, 1, &pp0, &pp1,
+				                           &pp2, NULL) == 0)
+				{
+					goto fail_segment;
+				}
 			}
-
-			self->nc = (int) strtol(kv->val->data, NULL, 0);
-		}
-		else if((strcmp(kv->key, "c") == 0) &&
-		        (kv->val->type == JSMN_TYPE_ARRAY))
-		{
-			if((self->nc < 0) || (self->c != NULL))
+			else if(t0 && t1)
 			{
-				LOGE("invalid nc=%i, c=%p",
-				     self->nc, self->c);
-				goto fail_glyph;
+				// straight line
+				if(glyph_object_addSegment(self, segs, &ns,
+				                           GLYPH_OBJECT_SEGMENT_LINE,
+				                           first, 1, &pp0, &pp1,
+				                           NULL, NULL) == 0)
+				{
+					goto fail_segment;
+				}
 			}
 
-			self->c = glyph_newContour(self->nc, kv->val->array);
-			if(self->c == NULL)
-			{
-				goto fail_glyph;
-			}
+			first = 0;
 		}
 
-		iter = cc_list_next(iter);
+		start = end + 1;
 	}
 
-	// validate data
-	if((self->name == NULL) ||
-	   (self->w    <  0.0f) ||
-	   (self->h    <  0.0f) ||
-	   (self->np   <  0)    ||
-	   (self->nc   <  0)    ||
-	   (self->p    == NULL) ||
-	   (self->t    == NULL) ||
-	   (self->c    == NULL))
-	{
-		LOGE("invalid name=%s, w=%f, h=%f, np=%i, nc=%i, p=%p, t=%p, c=%p",
-		     self->name ? self->name : "NULL", self->w, self->h,
-		     self->np, self->nc,
-		     self->p, self->t, self->c);
-		goto fail_glyph;
+	if(glyph_object_pack(self, segs, ns) == 0)
+	{
+		goto fail_pack;
 	}
 
+	FREE(segs);
+
 	// success
-	return self;
+	return 1;
 
 	// failure
-	fail_glyph:
-		FREE(self->c);
-		FREE(self->t);
-		FREE(self->p);
-		FREE(self->name);
-		FREE(self);
-	return NULL;
+	fail_pack:
+	fail_segment:
+		FREE(segs);
+	return 0;
 }
 
-void glyph_object_delete(glyph_object_t** _self)
+static int
+glyph_object_validate(int* _steps, int thresh)
 {
-	ASSERT(_self);
+	ASSERT(_steps);
+
+	// negative values have no meaning and a zero steps with
+	// a zero thresh selects the naive algorithm
+	if((*_steps < 0) || (thresh < 0))
+	{
+		LOGE("invalid steps=%i, thresh=%i", *_steps, thresh);
+		return 0;
+	}
 
-	glyph_object_t* self = *_self;
-	if(self)
+	// the subdivision buffers hold at most
+	// GLYPH_OBJECT_MAX_STEPS points per segment
+	if(*_steps > GLYPH_OBJECT_MAX_STEPS)
 	{
-		vkk_vgPolygon_delete(&self->poly);
-		FREE(self->c);
-		FREE(self->t);
-		FREE(self->p);
-		FREE(self->name);
-		FREE(self);
-		*_self = NULL;
+		LOGW("invalid steps=%i", *_steps);
+		*_steps = GLYPH_OBJECT_MAX_STEPS;
 	}
+
+	return 1;
 }
 
 static int
-glyph_object_interpolate(glyph_object_t* self,
-                         vkk_vgPolygonBuilder_t* pb,
-                         int* _first,
-                         int steps, int thresh,
-                         float* _err, int* _cnt,
-                         cc_vec2f_t* p0,
-                         cc_vec2f_t* p1,
-                         cc_vec2f_t* p2)
+glyph_object_emitPoints(glyph_object_t* self,
+                        glyph_sink_t* sink,
+                        int steps,
+                        int thresh,
+                        int flags,
+                        glyph_stats_t* stats)
 {
 	ASSERT(self);
-	ASSERT(pb);
-	ASSERT(_first);
-	ASSERT(_err);
-	ASSERT(_cnt);
-	ASSERT(p0);
-	ASSERT(p2);
-	ASSERT(p2);
-
-	// optionally compute adaptive subdivision steps
-	int   i;
-	float t;
-	if(thresh > 0)
-	{
-		// compute points and measure distance
-		cc_vec2f_t pts[17];
-		float      dist = 0.0f;
-		for(i = 0; i <= 16; ++i)
-		{
-			t = ((float) i)/((float) 16);
-			cc_vec2f_quadraticBezier(p0, p1, p2, t, &pts[i]);
-
-			if(i > 0)
-			{
-				cc_vec2f_t delta;
-				cc_vec2f_subv_copy(&pts[i], &pts[i - 1], &delta);
-				dist += cc_vec2f_mag(&delta);
-			}
-		}
-
-		// compute error between each subdivision step
-		// e1:  0----------------16
-		// e2:  0--------8--------16
-		// e4:  0----4----8----C----16
-		// e8:  0--2--4--6--8--A--C--E--16
-		float e1  = cc_vec2f_triangleArea(&pts[ 0], &pts[ 1], &pts[ 2]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 2], &pts[ 3]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 3], &pts[ 4]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 4], &pts[ 5]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 5], &pts[ 6]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 6], &pts[ 7]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 7], &pts[ 8]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 8], &pts[ 9]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 9], &pts[10]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[10], &pts[11]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[11], &pts[12]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[12], &pts[13]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[13], &pts[14]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[14], &pts[15]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[15], &pts[16]);
-		float e2  = cc_vec2f_triangleArea(&pts[ 0], &pts[ 1], &pts[ 2]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 2], &pts[ 3]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 3], &pts[ 4]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 4], &pts[ 5]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 5], &pts[ 6]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 6], &pts[ 7]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 7], &pts[ 8]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[ 9], &pts[10]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[10], &pts[11]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[11], &pts[12]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[12], &pts[13]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[13], &pts[14]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[14], &pts[15]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[15], &pts[16]);
-		float e4  = cc_vec2f_triangleArea(&pts[ 0], &pts[ 1], &pts[ 2]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 2], &pts[ 3]) +
-		            cc_vec2f_triangleArea(&pts[ 0], &pts[ 3], &pts[ 4]) +
-		            cc_vec2f_triangleArea(&pts[ 4], &pts[ 5], &pts[ 6]) +
-		            cc_vec2f_triangleArea(&pts[ 4], &pts[ 6], &pts[ 7]) +
-		            cc_vec2f_triangleArea(&pts[ 4], &pts[ 7], &pts[ 8]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[ 9], &pts[10]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[10], &pts[11]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[11], &pts[12]) +
-		            cc_vec2f_triangleArea(&pts[12], &pts[13], &pts[14]) +
-		            cc_vec2f_triangleArea(&pts[12], &pts[14], &pts[15]) +
-		            cc_vec2f_triangleArea(&pts[12], &pts[15], &pts[16]);
-		float e8  = cc_vec2f_triangleArea(&pts[ 0], &pts[ 1], &pts[ 2]) +
-		            cc_vec2f_triangleArea(&pts[ 2], &pts[ 3], &pts[ 4]) +
-		            cc_vec2f_triangleArea(&pts[ 4], &pts[ 5], &pts[ 6]) +
-		            cc_vec2f_triangleArea(&pts[ 6], &pts[ 7], &pts[ 8]) +
-		            cc_vec2f_triangleArea(&pts[ 8], &pts[ 9], &pts[10]) +
-		            cc_vec2f_triangleArea(&pts[10], &pts[11], &pts[12]) +
-		            cc_vec2f_triangleArea(&pts[12], &pts[13], &pts[14]) +
-		            cc_vec2f_triangleArea(&pts[14], &pts[15], &pts[16]);
-
-		// scale error by 1/dist
-		e1 /= dist;
-		e2 /= dist;
-		e4 /= dist;
-		e8 /= dist;
+	ASSERT(sink);
+	ASSERT(stats);
 
-		// threshold steps
-		float err     = 0.0f;
-		float threshf = ((float) thresh)/(10000.0f);
-		if(e1 < threshf)
-		{
-			steps  = 1;
-			err    = e1;
-			*_err += e1;
-		}
-		else if(e2 < threshf)
+	// check algorithm
+	int                    i;
+	int                    first  = 1;
+	glyph_objectStream_t*  stream = self->stream;
+	glyph_objectSegment_t* seg    = stream->segs;
+	if((steps == 0) && (thresh == 0))
+	{
+		// naive algorithm adds the ON points
+		for(i = 0; i < stream->ns; ++i, ++seg)
 		{
-			steps  = 2;
-			err    = e2;
-			*_err += e2;
+			if(seg->first)
+			{
+				first = 1;
+			}
+
+			if(seg->on == 0)
+			{
+				continue;
+			}
+
+			float x;
+			float y;
+			glyph_object_endPoint(stream, seg, &x, &y);
+			if(glyph_sink_point(sink, first, x, y) == 0)
+			{
+				return 0;
+			}
+
+			stats->points += 1;
+			first = 0;
 		}
-		else if(e4 < threshf)
+
+		LOGD("NAIVE(%s): cnt=%i", glyph_object_name(self),
+		     stats->points);
+	}
+	else
+	{
+		// bezier interpolation algorithm
+		// ASA selects at most GLYPH_OBJECT_MAX_STEPS steps
+		// which is a multiple of the selected steps
+		glyph_objectBatch_t batch;
+		glyph_object_initBatch(&batch, (thresh > 0) ?
+		                       GLYPH_OBJECT_MAX_STEPS : steps);
+		for(i = 0; i < stream->ns; ++i, ++seg)
 		{
-			steps  = 4;
-			err    = e4;
-			*_err += e4;
+			if(seg->first)
+			{
+				first = 1;
+			}
+
+			if(seg->type == GLYPH_OBJECT_SEGMENT_CONIC)
+			{
+				if(glyph_object_interpolate(self, sink, &first,
+				                            steps, thresh, flags,
+				                            stats, &batch,
+				                            seg) == 0)
+				{
+					return 0;
+				}
+			}
+			else if(seg->type == GLYPH_OBJECT_SEGMENT_CUBIC)
+			{
+				if(glyph_object_interpolateCubic(self, sink,
+				                                 &first, steps,
+				                                 thresh, flags,
+				                                 stats, seg) == 0)
+				{
+					return 0;
+				}
+			}
+			else
+			{
+				// straight line
+				if(glyph_sink_point(sink, first,
+				                    stream->lx[seg->idx],
+				                    stream->ly[seg->idx]) == 0)
+				{
+					return 0;
+				}
+
+				stats->lines  += 1;
+				stats->points += 1;
+				first = 0;
+			}
 		}
-		else if(e8 < threshf)
+
+		if(stats->err == 0.0f)
 		{
-			steps  = 8;
-			err    = e8;
-			*_err += e8;
+			LOGD("FIXED(%s): cnt=%i, steps=%i",
+			     glyph_object_name(self), stats->points, steps);
 		}
 		else
 		{
-			steps = 16;
+			LOGD("ADAPTIVE(%s), cnt=%i, thresh=%i, err=%f",
+			     glyph_object_name(self), stats->points, thresh,
+			     stats->err);
 		}
+	}
+
+	return 1;
+}
+
+int glyph_object_emit(glyph_object_t* self,
+                      glyph_sink_t* sink,
+                      int steps, int thresh, int flags,
+                      glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(stats);
 
-		LOGI("steps=%i, dist=%f, err=%f, e: %f, %f, %f, %f",
-		     steps, dist, err, e1, e2, e4, e8);
+	if(glyph_object_validate(&steps, thresh) == 0)
+	{
+		return 0;
 	}
 
-	// perform subdivision
-	cc_vec2f_t p;
-	for(i = 1; i <= steps; ++i)
+	// glyphs without an outline emit nothing
+	// e.g. space character
+	if(self->np < 3)
 	{
-		t = ((float) i)/((float) steps);
-		cc_vec2f_quadraticBezier(p0, p1, p2, t, &p);
-		if(vkk_vgPolygonBuilder_point(pb, *_first,
-		                              p.x,
-		                              p.y) == 0)
-		{
-			return 0;
-		}
+		return 1;
+	}
+
+	// decompose the contours once on the first build
+	if((self->stream == NULL) &&
+	   (glyph_object_compile(self) == 0))
+	{
+		return 0;
+	}
+
+	double t0 = cc_timestamp();
 
-		*_cnt  += 1;
-		*_first = 0;
+	if(glyph_object_emitPoints(self, sink, steps, thresh,
+	                           flags, stats) == 0)
+	{
+		return 0;
 	}
 
+	stats->build_time += cc_timestamp() - t0;
+
 	return 1;
 }
 
-vkk_vgPolygon_t*
-glyph_object_build(glyph_object_t* self,
-                   vkk_vgPolygonBuilder_t* pb,
-                   int steps,
-                   int thresh)
+int glyph_object_buildMesh(glyph_object_t* self,
+                           glyph_sink_t* sink,
+                           glyph_tess_t* tess,
+                           glyph_arena_t* arena,
+                           glyph_arenaMesh_t* mesh,
+                           int steps,
+                           int thresh,
+                           int flags,
+                           glyph_stats_t* stats)
 {
 	ASSERT(self);
-	ASSERT(pb);
+	ASSERT(sink);
+	ASSERT(tess);
+	ASSERT(arena);
+	ASSERT(mesh);
+	ASSERT(stats);
 
-	// check for cached polygon
-	if(self->poly)
+	glyph_stats_reset(stats);
+
+	if(glyph_object_validate(&steps, thresh) == 0)
 	{
-		if((self->last_steps  == steps) &&
-		   (self->last_thresh == thresh))
-		{
-			return self->poly;
-		}
-		else
-		{
-			vkk_vgPolygon_delete(&self->poly);
-		}
+		return 0;
 	}
 
-	// minimal check to eliminate incomplete polygons
+	// minimal check to eliminate incomplete meshes
 	// e.g. space character
 	if(self->np < 3)
 	{
-		return NULL;
+		return 0;
+	}
+
+	glyph_sink_reset(sink);
+	if(glyph_object_emit(self, sink, steps, thresh,
+	                     flags, stats) == 0)
+	{
+		return 0;
 	}
 
-	vkk_vgPolygonBuilder_reset(pb);
+	double t1 = cc_timestamp();
 
-	// check algorithm
-	int cnt = 0;
-	if((steps == 0) && (thresh == 0))
+	if(glyph_tess_build(tess, sink, arena, mesh) == 0)
 	{
-		// naive algorithm
-		int p;
-		int c     = 0;
-		int first = 1;
-		for(p = 0; p < self->np; ++p)
-		{
-			// skip control points at start of contour
-			if(first && (self->t[p] == 0))
-			{
-				continue;
-			}
+		return 0;
+	}
 
-			// add non-control points
-			if(self->t[p])
-			{
-				if(vkk_vgPolygonBuilder_point(pb, first,
-				                              self->p[p].x,
-				                              self->p[p].y) == 0)
-				{
-					return NULL;
-				}
+	stats->builds    = 1;
+	stats->tess_time = cc_timestamp() - t1;
 
-				cnt  += 1;
-				first = 0;
-			}
+	return 1;
+}
 
-			// detect end of contour
-			if(self->c[c] == p)
-			{
-				first = 1;
-				++c;
-			}
-		}
+int glyph_object_prepare(glyph_object_t* self)
+{
+	ASSERT(self);
 
-		LOGI("NAIVE(%s): cnt=%i", self->name, cnt);
-	}
-	else
+	// see glyph_object_emit
+	if(self->np < 3)
 	{
-		// bezier interpolation algorithm
-		// The following rules are applied to decompose the
-		// contour's points into segments and arcs:
-		// 1) Two successive ON points indicate a line
-		//    segment joining them.
-		// 2) One conic OFF point between two ON points
-		//    indicates a conic Bezier arc, the OFF point
-		//    being the control point, and the ON ones the
-		//    start and end points.
-		// 3) Two successive conic OFF points force the rasterizer
-		//    to create a virtual ON point inbetween, at their
-		//    exact middle.
-		// 4) The last point in a contour uses the first as an end
-		//    point to create a closed contour.
-		// 5) The first point in a contour can be a conic OFF
-		//    point itself. In that case, use the last point of
-		//    the contour as the contour's starting point. If the
-		//    last point is a conic OFF point itself, start the
-		//    contour with the virtual ON point between the last
-		//    and first point of the contour.
-		// Note: Cubic curves are not supported.
-		// https://freetype.org/freetype2/docs/glyphs/glyphs-6.html
-
-		int c;
-		int p;
-		int p0;
-		int p1;
-		int p2;
-		int t0;
-		int t1;
-		int t2;
-		int start = 0;
-		int end   = 0;
-		int first = 1;
-		cc_vec2f_t* pp0;
-		cc_vec2f_t* pp1;
-		cc_vec2f_t* pp2;
-		cc_vec2f_t  ppi;
-		cc_vec2f_t  ppj;
-		float       err = 0.0f;
-		for(c = 0; c < self->nc; ++c)
-		{
-			first = 1;
-			end   = self->c[c];
-
-			for(p = start; p <= end; ++p)
-			{
-				p0  = ((p - 1) < start) ? end : p - 1;
-				p1  = p;
-				p2  = ((p + 1) > end) ? start : p + 1;
-				pp0 = &self->p[p0];
-				pp1 = &self->p[p1];
-				pp2 = &self->p[p2];
-				t0  = self->t[p0];
-				t1  = self->t[p1];
-				t2  = self->t[p2];
-
-				// apply contour rules
-				// 000 - interpolate (pi,pj]
-				// 001 - interpolate (pi,p2]
-				// 01X - skip
-				// 100 - interpolate (p0,pj]
-				// 101 - interpolate (p0,p2]
-				// 11X - straight line [p2]
-				if((t0 == 0) && (t1 == 0) && (t2 == 0))
-				{
-					// add virtual point between p0 and p1
-					ppi.x = pp0->x + (pp1->x - pp0->x)/2.0f;
-					ppi.y = pp0->y + (pp1->y - pp0->y)/2.0f;
-
-					// add virtual point between p1 and p2
-					ppj.x = pp1->x + (pp2->x - pp1->x)/2.0f;
-					ppj.y = pp1->y + (pp2->y - pp1->y)/2.0f;
-
-					// interpolate contour between pi and pj
-					if(glyph_object_interpolate(self, pb, &first,
-					                            steps, thresh, &err, &cnt,
-					                            &ppi, pp1, &ppj) == 0)
-					{
-						return NULL;
-					}
-				}
-				else if((t0 == 0) && (t1 == 0) && t2)
-				{
-					// add virtual point between p0 and p1
-					ppi.x = pp0->x + (pp1->x - pp0->x)/2.0f;
-					ppi.y = pp0->y + (pp1->y - pp0->y)/2.0f;
-
-					// interpolate contour between pi and p2
-					if(glyph_object_interpolate(self, pb, &first,
-					                            steps, thresh, &err, &cnt,
-					                            &ppi, pp1, pp2) == 0)
-					{
-						return NULL;
-					}
-				}
-				else if((t0 == 0) && t1)
-				{
-					// skip
-				}
-				else if(t0 && (t1 == 0) && (t2 == 0))
-				{
-					// add virtual point between p1 and p2
-					ppj.x = pp1->x + (pp2->x - pp1->x)/2.0f;
-					ppj.y = pp1->y + (pp2->y - pp1->y)/2.0f;
-
-					// interpolate contour between p0 and pj
-					if(glyph_object_interpolate(self, pb, &first,
-					                            steps, thresh, &err, &cnt,
-					                            pp0, pp1, &ppj) == 0)
-					{
-						return NULL;
-					}
-				}
-				else if(t0 && (t1 == 0) && t2)
-				{
-					// interpolate contour between p0 and p2
-					if(glyph_object_interpolate(self, pb, &first,
-					                            steps, thresh, &err, &cnt,
-					                            pp0, pp1, pp2) == 0)
-					{
-						return NULL;
-					}
-				}
-				else if(t0 && t1)
-				{
-					// straight line
-					if(vkk_vgPolygonBuilder_point(pb, first, pp1->x,
-					                              pp1->y) == 0)
-					{
-						return NULL;
-					}
-
-					cnt  += 1;
-					first = 0;
-				}
-			}
+		return 0;
+	}
 
-			start = end + 1;
-		}
+	if((self->stream == NULL) &&
+	   (glyph_object_compile(self) == 0))
+	{
+		return 0;
+	}
 
-		if(err == 0.0f)
+	// the glyph is only read by builds once every error
+	// table has been computed
+	int                    i;
+	glyph_objectStream_t*  stream = self->stream;
+	glyph_objectSegment_t* seg    = stream->segs;
+	for(i = 0; i < stream->ns; ++i, ++seg)
+	{
+		if(seg->type != GLYPH_OBJECT_SEGMENT_LINE)
 		{
-			LOGI("FIXED(%s): cnt=%i, steps=%i",
-			     self->name, cnt, steps);
+			glyph_object_segmentError(stream, seg, 0);
+			glyph_object_segmentError(stream, seg,
+			                          GLYPH_OBJECT_FLAG_ANALYTIC);
 		}
-		else
+	}
+
+	return 1;
+}
+
+int glyph_object_samePoints(glyph_object_t* self,
+                           int steps0, int thresh0, int flags0,
+                           int steps1, int thresh1, int flags1)
+{
+	ASSERT(self);
+
+	// the points of recursive subdivision are only known
+	// after the subdivision
+	if(((thresh0 > 0) && (flags0 & GLYPH_OBJECT_FLAG_RECURSIVE)) ||
+	   ((thresh1 > 0) && (flags1 & GLYPH_OBJECT_FLAG_RECURSIVE)) ||
+	   ((flags0 ^ flags1) & GLYPH_OBJECT_FLAG_FORWARD)          ||
+	   (self->stream == NULL))
+	{
+		return 0;
+	}
+
+	// otherwise the points are determined by the steps of
+	// each segment
+	int                    i;
+	glyph_objectStream_t*  stream = self->stream;
+	glyph_objectSegment_t* seg    = stream->segs;
+	for(i = 0; i < stream->ns; ++i, ++seg)
+	{
+		if(glyph_object_segmentSteps(stream, seg, steps0,
+		                             thresh0, flags0) !=
+		   glyph_object_segmentSteps(stream, seg, steps1,
+		                             thresh1, flags1))
 		{
-			LOGI("ADAPTIVE(%s), cnt=%i, thresh=%i, err=%f",
-			     self->name, cnt, thresh, err);
+			return 0;
 		}
 	}
 
-	self->poly = vkk_vgPolygonBuilder_build(pb);
+	return 1;
+}
+
+int glyph_object_lodLevel(glyph_object_t* self,
+                          float tolerance, float height,
+                          int level)
+{
+	ASSERT(self);
+
+	if((tolerance <= 0.0f) || (height <= 0.0f) ||
+	   (self->h <= 0.0f))
+	{
+		return -1;
+	}
+
+	// the ASA average error is a distance in glyph units so
+	// the pixel tolerance converts directly to a threshold
+	// which is quantized to levels of thresh=2^level
+	float threshf = tolerance*self->h/height;
+	float levelf  = log2f(10000.0f*threshf);
+
+	// apply hysteresis to the current level so that a glyph
+	// near a level boundary is not rebuilt every frame
+	if((level < 0) ||
+	   (fabsf(levelf - ((float) level)) >
+	    0.5f + GLYPH_OBJECT_LOD_HYSTERESIS))
+	{
+		level = (int) floorf(levelf + 0.5f);
+	}
 
-	self->last_steps  = steps;
-	self->last_thresh = thresh;
+	if(level < 0)
+	{
+		level = 0;
+	}
+	else if(level >= GLYPH_OBJECT_LOD_COUNT)
+	{
+		level = GLYPH_OBJECT_LOD_COUNT - 1;
+	}
 
-	return self->poly;
+	return level;
 }
@@ -24,40 +24,145 @@
 #ifndef glyph_object_H
 #define glyph_object_H
 
-#include "jsmn/wrapper/jsmn_wrapper.h"
+#include <stdint.h>
+
 #include "libcc/math/cc_vec2f.h"
-#include "libvkk/vkk_vg.h"
+#include "glyph_arena.h"
+#include "glyph_pack.h"
+#include "glyph_parser.h"
+#include "glyph_sink.h"
+#include "glyph_stats.h"
+#include "glyph_tess.h"
+
+struct glyph_font_s;
+
+// point tags
+// Two successive cubic OFF points are the control points of
+// a cubic Bezier arc joining the surrounding ON points.
+#define GLYPH_OBJECT_TAG_CONIC 0
+#define GLYPH_OBJECT_TAG_ON    1
+#define GLYPH_OBJECT_TAG_CUBIC 2
+
+// maximum subdivision steps per segment
+#define GLYPH_OBJECT_MAX_STEPS 16
+
+// select the closed form ASA error metric rather than the
+// sampled Heron metric
+#define GLYPH_OBJECT_FLAG_ANALYTIC 1
+
+// emit subdivision points by forward differencing which
+// is within GLYPH_BEZIER_FORWARD_TOL of the exact points
+#define GLYPH_OBJECT_FLAG_FORWARD 2
+
+// subdivide ASA segments recursively by refining the span
+// with the largest error until the average error of the
+// segment is below the threshold
+// the spans are split at most GLYPH_OBJECT_MAX_DEPTH times
+// so a segment has at most GLYPH_OBJECT_MAX_STEPS spans
+// regardless of the steps
+#define GLYPH_OBJECT_FLAG_RECURSIVE 4
+#define GLYPH_OBJECT_MAX_DEPTH      4
+
+// pixel tolerance LOD levels are built with thresh=2^level
+// and a level is retained until the ideal level moves more
+// than GLYPH_OBJECT_LOD_HYSTERESIS past its boundary
+#define GLYPH_OBJECT_LOD_COUNT      8
+#define GLYPH_OBJECT_LOD_HYSTERESIS 0.25f
 
+// lazy state of a glyph which failed to decode
+#define GLYPH_OBJECT_LAZY_FAILED -1
+
+// glyphs are views of the font arena
 typedef struct glyph_object_s
 {
-	char* name;
+	struct glyph_font_s* font;
+
+	// offset into the font names
+	uint32_t name;
+
+	// code point parsed from the name
+	// or GLYPH_PACK_CODE_NONE
+	uint32_t code;
 
 	float w;
 	float h;
 
-	// points
-	int         np;
-	cc_vec2f_t* p;
-
-	// tags
-	int* t;
+	// points and tags
+	int np;
+	int p;
 
 	// contours
-	int  nc;
-	int* c;
+	int nc;
+	int c;
 
-	// build glyph on demand
-	vkk_vgPolygon_t* poly;
+	// byte range of an undecoded glyph in the font
+	// resource when loaded lazily
+	// lazy is GLYPH_OBJECT_LAZY_FAILED when the decode failed
+	// so that it is only attempted once
+	int    lazy;
+	size_t offset;
+	size_t size;
 
-	int last_steps;
-	int last_thresh;
+	// segment stream decomposed from the contours on the
+	// first build with the virtual ON points resolved
+	// glyph_object_prepare also computes the error tables so
+	// that concurrent builds of a prepared glyph only read it
+	struct glyph_objectStream_s* stream;
+
+	// statistics of the last build which are stored by
+	// the polygon cache and the build pool
+	glyph_stats_t stats;
 } glyph_object_t;
 
-glyph_object_t*  glyph_object_new(jsmn_object_t* obj);
-void             glyph_object_delete(glyph_object_t** _self);
-vkk_vgPolygon_t* glyph_object_build(glyph_object_t* self,
-                                    vkk_vgPolygonBuilder_t* pb,
-                                    int steps,
-                                    int thresh);
+int         glyph_object_parse(glyph_object_t* self,
+                               struct glyph_font_s* font,
+                               glyph_parser_t* parser);
+int         glyph_object_scan(glyph_object_t* self,
+                              struct glyph_font_s* font,
+                              glyph_parser_t* parser);
+int         glyph_object_decode(glyph_object_t* self,
+                                const char* data);
+void        glyph_object_initPack(glyph_object_t* self,
+                                  struct glyph_font_s* font,
+                                  glyph_pack_t* pack,
+                                  uint32_t idx);
+void        glyph_object_finish(glyph_object_t* self);
+const char* glyph_object_name(glyph_object_t* self);
+uint32_t    glyph_object_code(const char* name);
+
+// glyph_object_emit appends the points of the glyph to
+// a sink and accumulates its statistics where steps are
+// clamped to GLYPH_OBJECT_MAX_STEPS
+int         glyph_object_emit(glyph_object_t* self,
+                              glyph_sink_t* sink,
+                              int steps,
+                              int thresh,
+                              int flags,
+                              glyph_stats_t* stats);
+
+// glyph_object_buildMesh selects the glyph tessellator
+// rather than libtess2 and builds the mesh into an arena
+int         glyph_object_buildMesh(glyph_object_t* self,
+                                   glyph_sink_t* sink,
+                                   glyph_tess_t* tess,
+                                   glyph_arena_t* arena,
+                                   glyph_arenaMesh_t* mesh,
+                                   int steps,
+                                   int thresh,
+                                   int flags,
+                                   glyph_stats_t* stats);
+
+int         glyph_object_prepare(glyph_object_t* self);
+int         glyph_object_samePoints(glyph_object_t* self,
+                                    int steps0,
+                                    int thresh0,
+                                    int flags0,
+                                    int steps1,
+                                    int thresh1,
+                                    int flags1);
+int         glyph_object_lodLevel(glyph_object_t* self,
+                                  float tolerance,
+                                  float height,
+                                  int level);
 
 #endif
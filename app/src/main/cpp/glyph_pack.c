@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_pack.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int glyph_pack_validate(glyph_pack_t* self)
+{
+	ASSERT(self);
+
+	const glyph_packHeader_t* header = self->header;
+
+	uint32_t i;
+	uint32_t j;
+	for(i = 0; i < header->count; ++i)
+	{
+		const glyph_packIndex_t* idx = &self->index[i];
+
+		if((idx->name >= header->size_names) ||
+		   (memchr(&self->names[idx->name], '\0',
+		           header->size_names - idx->name) == NULL))
+		{
+			LOGE("invalid i=%u, name=%u", i, idx->name);
+			return 0;
+		}
+
+		if((idx->p  > header->np) ||
+		   (idx->np > header->np - idx->p) ||
+		   (idx->c  > header->nc) ||
+		   (idx->nc > header->nc - idx->c))
+		{
+			LOGE("invalid i=%u, p=%u, np=%u, c=%u, nc=%u",
+			     i, idx->p, idx->np, idx->c, idx->nc);
+			return 0;
+		}
+
+		// contour end points must be increasing and in range
+		int32_t last = -1;
+		for(j = 0; j < idx->nc; ++j)
+		{
+			int32_t end = self->c[idx->c + j];
+			if((end <= last) || (end >= (int32_t) idx->np))
+			{
+				LOGE("invalid i=%u, end=%i, np=%u",
+				     i, end, idx->np);
+				return 0;
+			}
+			last = end;
+		}
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_pack_t*
+glyph_pack_open(const char* path, const char* name)
+{
+	ASSERT(path);
+	ASSERT(name);
+
+	// the pack layout is little-endian and is used in place
+	// so the font falls back to the JSON resource on a
+	// big-endian host
+	uint32_t endian = 1;
+	if(*((uint8_t*) &endian) != 1)
+	{
+		LOGE("big-endian is not supported");
+		return NULL;
+	}
+
+	glyph_pack_t* self;
+	self = (glyph_pack_t*) CALLOC(1, sizeof(glyph_pack_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	// the pack is optional
+	self->res = glyph_resource_open(path, name);
+	if(self->res == NULL)
+	{
+		goto fail_res;
+	}
+
+	size_t size = self->res->size;
+	if(size < sizeof(glyph_packHeader_t))
+	{
+		LOGE("invalid size=%i", (int) size);
+		goto fail_header;
+	}
+
+	const glyph_packHeader_t* header;
+	header = (const glyph_packHeader_t*) self->res->data;
+	if((header->magic   != GLYPH_PACK_MAGIC) ||
+	   (header->version != GLYPH_PACK_VERSION))
+	{
+		LOGE("invalid magic=0x%X, version=%u",
+		     header->magic, header->version);
+		goto fail_header;
+	}
+
+	if(glyph_pack_size(header->count, header->np,
+	                   header->nc, header->size_names) != size)
+	{
+		LOGE("invalid size=%i, count=%u, np=%u, nc=%u, size_names=%u",
+		     (int) size, header->count, header->np,
+		     header->nc, header->size_names);
+		goto fail_header;
+	}
+
+	// resolve sections
+	const char* base = self->res->data;
+	size_t      offset;
+	offset        = sizeof(glyph_packHeader_t);
+	self->header  = header;
+	self->index   = (const glyph_packIndex_t*) (base + offset);
+	offset       += header->count*sizeof(glyph_packIndex_t);
+	self->x       = (const float*) (base + offset);
+	offset       += header->np*sizeof(float);
+	self->y       = (const float*) (base + offset);
+	offset       += header->np*sizeof(float);
+	self->c       = (const int32_t*) (base + offset);
+	offset       += header->nc*sizeof(int32_t);
+	self->t       = (const uint8_t*) (base + offset);
+	offset       += header->np*sizeof(uint8_t);
+	self->names   = base + offset;
+
+	if(glyph_pack_validate(self) == 0)
+	{
+		goto fail_header;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_header:
+		glyph_resource_close(&self->res);
+	fail_res:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_pack_close(glyph_pack_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_pack_t* self = *_self;
+	if(self)
+	{
+		glyph_resource_close(&self->res);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+uint32_t glyph_pack_count(glyph_pack_t* self)
+{
+	ASSERT(self);
+
+	return self->header->count;
+}
+
+size_t glyph_pack_size(uint32_t count, uint32_t np,
+                       uint32_t nc, uint32_t size_names)
+{
+	return sizeof(glyph_packHeader_t)                 +
+	       ((size_t) count)*sizeof(glyph_packIndex_t) +
+	       ((size_t) 2*np)*sizeof(float)              +
+	       ((size_t) nc)*sizeof(int32_t)              +
+	       ((size_t) np)*sizeof(uint8_t)              +
+	       ((size_t) size_names);
+}
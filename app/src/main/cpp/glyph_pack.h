@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_pack_H
+#define glyph_pack_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "glyph_resource.h"
+
+// The glyph pack is a precompiled binary form of the JSON
+// glyph description which may be memory mapped and used
+// in place. All fields are little-endian and each section
+// is 4-byte aligned (except tags and names). The pack is
+// neither exported nor opened on a big-endian host.
+//
+// header
+// index[count]
+// x[np]         (float)
+// y[np]         (float)
+// c[nc]         (int32_t contour end points)
+// t[np]         (uint8_t tags)
+// names[size_names]
+//
+// The point and contour arrays match the layout of the
+// font arena. The index p/c fields are offsets into the
+// point and contour arrays. The contour end points are relative to
+// the first point of the glyph as in the JSON description.
+
+#define GLYPH_PACK_MAGIC   0x4B415047
+#define GLYPH_PACK_VERSION 2
+
+#define GLYPH_PACK_CODE_NONE 0xFFFFFFFF
+
+typedef struct glyph_packHeader_s
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t count;
+	uint32_t np;
+	uint32_t nc;
+	uint32_t size_names;
+	uint32_t reserved[2];
+} glyph_packHeader_t;
+
+typedef struct glyph_packIndex_s
+{
+	uint32_t code;
+	uint32_t name;
+	float    w;
+	float    h;
+	uint32_t p;
+	uint32_t np;
+	uint32_t c;
+	uint32_t nc;
+} glyph_packIndex_t;
+
+typedef struct glyph_pack_s
+{
+	glyph_resource_t* res;
+
+	const glyph_packHeader_t* header;
+	const glyph_packIndex_t*  index;
+	const float*              x;
+	const float*              y;
+	const int32_t*            c;
+	const uint8_t*            t;
+	const char*               names;
+} glyph_pack_t;
+
+glyph_pack_t* glyph_pack_open(const char* path,
+                              const char* name);
+void          glyph_pack_close(glyph_pack_t** _self);
+uint32_t      glyph_pack_count(glyph_pack_t* self);
+size_t        glyph_pack_size(uint32_t count, uint32_t np,
+                              uint32_t nc, uint32_t size_names);
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+
+#define LOG_TAG "glyph-pack"
+#include "libcc/cc_log.h"
+#include "glyph_font.h"
+
+/***********************************************************
+* main                                                     *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	if(argc != 3)
+	{
+		LOGE("usage: %s font.json font.gpk", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char* fname_json = argv[1];
+	const char* fname_pack = argv[2];
+
+	glyph_font_t* font = glyph_font_newFile(fname_json,
+	                                        GLYPH_FONT_FLAG_THREADED);
+	if(font == NULL)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if(glyph_font_exportPack(font, fname_pack) == 0)
+	{
+		goto fail_export;
+	}
+
+	glyph_font_delete(&font);
+
+	// success
+	return EXIT_SUCCESS;
+
+	// failure
+	fail_export:
+		glyph_font_delete(&font);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "glyph_parser.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int glyph_parser_isDelimiter(int c)
+{
+	return (c == ',')  || (c == ':')  || (c == ']')  ||
+	       (c == '}')  || (c == ' ')  || (c == '\t') ||
+	       (c == '\r') || (c == '\n') || (c == '\0');
+}
+
+static int
+glyph_parser_token(glyph_parser_t* self, char* buf, size_t size)
+{
+	ASSERT(self);
+	ASSERT(buf);
+
+	const char* str = NULL;
+	size_t      len = 0;
+	if(glyph_parser_primitive(self, &str, &len) == 0)
+	{
+		return 0;
+	}
+
+	if(len >= size)
+	{
+		LOGE("invalid len=%i", (int) len);
+		return 0;
+	}
+
+	memcpy(buf, str, len);
+	buf[len] = '\0';
+
+	return 1;
+}
+
+// powers of ten which are exactly representable as floats
+static const float GLYPH_PARSER_POW10[] =
+{
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+	1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+static int
+glyph_parser_fastFloat(glyph_parser_t* self, float* _val)
+{
+	ASSERT(self);
+	ASSERT(_val);
+
+	// fast path for the fixed point decimals emitted by
+	// font-outline (e.g. -0.102656) which does not depend
+	// on the locale
+	//
+	// the mantissa is limited to 7 digits and the exponent
+	// to 10 fractional digits such that both the mantissa
+	// and the power of ten are exact floats and the single
+	// division is correctly rounded like strtof
+	const char* str  = &self->str[self->pos];
+	const char* end  = &self->str[self->size];
+	const char* s    = str;
+	int         neg  = 0;
+	int         m    = 0;
+	int         nd   = 0;
+	int         nf   = 0;
+	if((s < end) && (*s == '-'))
+	{
+		neg = 1;
+		++s;
+	}
+
+	while((s < end) && (*s >= '0') && (*s <= '9'))
+	{
+		m = 10*m + (*s - '0');
+		++nd;
+		++s;
+	}
+
+	if((s < end) && (*s == '.'))
+	{
+		++s;
+		while((s < end) && (*s >= '0') && (*s <= '9'))
+		{
+			m = 10*m + (*s - '0');
+			++nd;
+			++nf;
+			++s;
+		}
+	}
+
+	if((nd == 0) || (nd > 7) || (nf > 10) ||
+	   ((s < end) && (glyph_parser_isDelimiter(*s) == 0)))
+	{
+		return 0;
+	}
+
+	float val = ((float) m)/GLYPH_PARSER_POW10[nf];
+	*_val = neg ? -val : val;
+
+	self->pos += (size_t) (s - str);
+
+	return 1;
+}
+
+static int
+glyph_parser_fastInt(glyph_parser_t* self, int* _val)
+{
+	ASSERT(self);
+	ASSERT(_val);
+
+	// fast path for short decimal integers
+	const char* str = &self->str[self->pos];
+	const char* end = &self->str[self->size];
+	const char* s   = str;
+	int         neg = 0;
+	int         val = 0;
+	int         nd  = 0;
+	if((s < end) && (*s == '-'))
+	{
+		neg = 1;
+		++s;
+	}
+
+	while((s < end) && (*s >= '0') && (*s <= '9'))
+	{
+		val = 10*val + (*s - '0');
+		++nd;
+		++s;
+	}
+
+	// leading zeros are octal for strtol base 0
+	if((nd == 0) || (nd > 9) || ((nd > 1) && (str[neg] == '0')) ||
+	   ((s < end) && (glyph_parser_isDelimiter(*s) == 0)))
+	{
+		return 0;
+	}
+
+	*_val = neg ? -val : val;
+
+	self->pos += (size_t) (s - str);
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+void glyph_parser_init(glyph_parser_t* self,
+                       const char* str, size_t size)
+{
+	ASSERT(self);
+	ASSERT(str);
+
+	self->str  = str;
+	self->size = size;
+	self->pos  = 0;
+}
+
+int glyph_parser_peek(glyph_parser_t* self)
+{
+	ASSERT(self);
+
+	// skip whitespace
+	while(self->pos < self->size)
+	{
+		int c = self->str[self->pos];
+		if((c == ' ')  || (c == '\t') ||
+		   (c == '\r') || (c == '\n'))
+		{
+			++self->pos;
+			continue;
+		}
+
+		return c;
+	}
+
+	return 0;
+}
+
+int glyph_parser_accept(glyph_parser_t* self, int c)
+{
+	ASSERT(self);
+
+	if(glyph_parser_peek(self) == c)
+	{
+		++self->pos;
+		return 1;
+	}
+
+	return 0;
+}
+
+int glyph_parser_expect(glyph_parser_t* self, int c)
+{
+	ASSERT(self);
+
+	if(glyph_parser_accept(self, c) == 0)
+	{
+		LOGE("invalid pos=%i, expected=%c, found=%c",
+		     (int) self->pos, (char) c,
+		     (char) glyph_parser_peek(self));
+		return 0;
+	}
+
+	return 1;
+}
+
+int glyph_parser_type(glyph_parser_t* self)
+{
+	ASSERT(self);
+
+	int c = glyph_parser_peek(self);
+	if(c == '{')
+	{
+		return GLYPH_PARSER_TYPE_OBJECT;
+	}
+	else if(c == '[')
+	{
+		return GLYPH_PARSER_TYPE_ARRAY;
+	}
+	else if(c == '"')
+	{
+		return GLYPH_PARSER_TYPE_STRING;
+	}
+	else if(glyph_parser_isDelimiter(c) == 0)
+	{
+		return GLYPH_PARSER_TYPE_PRIMITIVE;
+	}
+
+	return GLYPH_PARSER_TYPE_NONE;
+}
+
+int glyph_parser_string(glyph_parser_t* self,
+                        const char** _str, size_t* _len)
+{
+	ASSERT(self);
+	ASSERT(_str);
+	ASSERT(_len);
+
+	if(glyph_parser_expect(self, '"') == 0)
+	{
+		return 0;
+	}
+
+	// escape sequences are preserved
+	size_t start = self->pos;
+	while(self->pos < self->size)
+	{
+		int c = self->str[self->pos];
+		if(c == '\\')
+		{
+			self->pos += 2;
+			continue;
+		}
+		else if(c == '"')
+		{
+			*_str = &self->str[start];
+			*_len = self->pos - start;
+			++self->pos;
+			return 1;
+		}
+
+		++self->pos;
+	}
+
+	LOGE("invalid string pos=%i", (int) start);
+	return 0;
+}
+
+int glyph_parser_primitive(glyph_parser_t* self,
+                           const char** _str, size_t* _len)
+{
+	ASSERT(self);
+	ASSERT(_str);
+	ASSERT(_len);
+
+	if(glyph_parser_type(self) != GLYPH_PARSER_TYPE_PRIMITIVE)
+	{
+		LOGE("invalid primitive pos=%i", (int) self->pos);
+		return 0;
+	}
+
+	size_t start = self->pos;
+	while((self->pos < self->size) &&
+	      (glyph_parser_isDelimiter(self->str[self->pos]) == 0))
+	{
+		++self->pos;
+	}
+
+	*_str = &self->str[start];
+	*_len = self->pos - start;
+
+	return 1;
+}
+
+int glyph_parser_float(glyph_parser_t* self, float* _val)
+{
+	ASSERT(self);
+	ASSERT(_val);
+
+	if((glyph_parser_type(self) == GLYPH_PARSER_TYPE_PRIMITIVE) &&
+	   glyph_parser_fastFloat(self, _val))
+	{
+		return 1;
+	}
+
+	// fall back to strtof for unusual input
+	// the buffer is not null terminated
+	char buf[64];
+	if(glyph_parser_token(self, buf, 64) == 0)
+	{
+		return 0;
+	}
+
+	*_val = strtof(buf, NULL);
+
+	return 1;
+}
+
+int glyph_parser_int(glyph_parser_t* self, int* _val)
+{
+	ASSERT(self);
+	ASSERT(_val);
+
+	if((glyph_parser_type(self) == GLYPH_PARSER_TYPE_PRIMITIVE) &&
+	   glyph_parser_fastInt(self, _val))
+	{
+		return 1;
+	}
+
+	// fall back to strtol for unusual input
+	// the buffer is not null terminated
+	char buf[64];
+	if(glyph_parser_token(self, buf, 64) == 0)
+	{
+		return 0;
+	}
+
+	*_val = (int) strtol(buf, NULL, 0);
+
+	return 1;
+}
+
+int glyph_parser_skip(glyph_parser_t* self)
+{
+	ASSERT(self);
+
+	const char* str;
+	size_t      len;
+
+	int type = glyph_parser_type(self);
+	if(type == GLYPH_PARSER_TYPE_OBJECT)
+	{
+		glyph_parser_expect(self, '{');
+		while(glyph_parser_accept(self, '}') == 0)
+		{
+			if((glyph_parser_string(self, &str, &len) == 0) ||
+			   (glyph_parser_expect(self, ':')        == 0) ||
+			   (glyph_parser_skip(self)               == 0) ||
+			   (glyph_parser_next(self, '}')          == 0))
+			{
+				return 0;
+			}
+		}
+		return 1;
+	}
+	else if(type == GLYPH_PARSER_TYPE_ARRAY)
+	{
+		glyph_parser_expect(self, '[');
+		while(glyph_parser_accept(self, ']') == 0)
+		{
+			if((glyph_parser_skip(self)      == 0) ||
+			   (glyph_parser_next(self, ']') == 0))
+			{
+				return 0;
+			}
+		}
+		return 1;
+	}
+	else if(type == GLYPH_PARSER_TYPE_STRING)
+	{
+		return glyph_parser_string(self, &str, &len);
+	}
+	else if(type == GLYPH_PARSER_TYPE_PRIMITIVE)
+	{
+		return glyph_parser_primitive(self, &str, &len);
+	}
+
+	LOGE("invalid pos=%i", (int) self->pos);
+	return 0;
+}
+
+int glyph_parser_skipFast(glyph_parser_t* self)
+{
+	ASSERT(self);
+
+	int type = glyph_parser_type(self);
+	if((type != GLYPH_PARSER_TYPE_OBJECT) &&
+	   (type != GLYPH_PARSER_TYPE_ARRAY))
+	{
+		return glyph_parser_skip(self);
+	}
+
+	// match the brackets of the container without
+	// tokenizing its values which must be validated later
+	size_t start = self->pos;
+	int    depth = 0;
+	while(self->pos < self->size)
+	{
+		int c = self->str[self->pos++];
+		if((c == '[') || (c == '{'))
+		{
+			++depth;
+		}
+		else if((c == ']') || (c == '}'))
+		{
+			--depth;
+			if(depth == 0)
+			{
+				return 1;
+			}
+		}
+		else if(c == '"')
+		{
+			while(self->pos < self->size)
+			{
+				c = self->str[self->pos++];
+				if(c == '\\')
+				{
+					++self->pos;
+				}
+				else if(c == '"')
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	LOGE("invalid pos=%i", (int) start);
+	return 0;
+}
+
+int glyph_parser_next(glyph_parser_t* self, int end)
+{
+	ASSERT(self);
+
+	// elements are separated by commas and the end of the
+	// container is consumed by the caller
+	if(glyph_parser_accept(self, ',') ||
+	   (glyph_parser_peek(self) == end))
+	{
+		return 1;
+	}
+
+	LOGE("invalid pos=%i, found=%c", (int) self->pos,
+	     (char) glyph_parser_peek(self));
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_parser_H
+#define glyph_parser_H
+
+#include <stddef.h>
+
+// The glyph parser is a forward-only JSON tokenizer which
+// reads values in place from a borrowed buffer. Unlike the
+// jsmn wrapper it does not build a DOM so the caller must
+// consume each value as it is encountered. Trailing commas
+// are accepted in arrays and objects to match the output
+// of font-outline.
+
+#define GLYPH_PARSER_TYPE_NONE      0
+#define GLYPH_PARSER_TYPE_OBJECT    1
+#define GLYPH_PARSER_TYPE_ARRAY     2
+#define GLYPH_PARSER_TYPE_STRING    3
+#define GLYPH_PARSER_TYPE_PRIMITIVE 4
+
+typedef struct glyph_parser_s
+{
+	const char* str;
+	size_t      size;
+	size_t      pos;
+} glyph_parser_t;
+
+void glyph_parser_init(glyph_parser_t* self,
+                       const char* str, size_t size);
+int  glyph_parser_peek(glyph_parser_t* self);
+int  glyph_parser_accept(glyph_parser_t* self, int c);
+int  glyph_parser_expect(glyph_parser_t* self, int c);
+int  glyph_parser_type(glyph_parser_t* self);
+int  glyph_parser_string(glyph_parser_t* self,
+                         const char** _str, size_t* _len);
+int  glyph_parser_primitive(glyph_parser_t* self,
+                            const char** _str, size_t* _len);
+int  glyph_parser_float(glyph_parser_t* self, float* _val);
+int  glyph_parser_int(glyph_parser_t* self, int* _val);
+int  glyph_parser_skip(glyph_parser_t* self);
+int  glyph_parser_skipFast(glyph_parser_t* self);
+int  glyph_parser_next(glyph_parser_t* self, int end);
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_polygon.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_polygon_point(void* priv, int first, float x, float y)
+{
+	ASSERT(priv);
+
+	vkk_vgPolygonBuilder_t* pb = (vkk_vgPolygonBuilder_t*) priv;
+
+	return vkk_vgPolygonBuilder_point(pb, first, x, y);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+vkk_vgPolygon_t*
+glyph_polygon_build(glyph_object_t* glyph,
+                    vkk_vgPolygonBuilder_t* pb,
+                    int steps,
+                    int thresh,
+                    int flags,
+                    glyph_stats_t* stats)
+{
+	ASSERT(glyph);
+	ASSERT(pb);
+	ASSERT(stats);
+
+	glyph_stats_reset(stats);
+
+	// minimal check to eliminate incomplete polygons
+	// e.g. space character
+	if(glyph->np < 3)
+	{
+		return NULL;
+	}
+
+	vkk_vgPolygonBuilder_reset(pb);
+
+	// the callback sink does not allocate
+	glyph_sink_t sink;
+	glyph_sink_init(&sink, (void*) pb, glyph_polygon_point);
+	if(glyph_object_emit(glyph, &sink, steps, thresh,
+	                     flags, stats) == 0)
+	{
+		return NULL;
+	}
+
+	double t1 = cc_timestamp();
+
+	vkk_vgPolygon_t* poly = vkk_vgPolygonBuilder_build(pb);
+
+	stats->builds    = 1;
+	stats->tess_time = cc_timestamp() - t1;
+
+	return poly;
+}
+
+int glyph_polygon_append(vkk_vgPolygonBuilder_t* pb,
+                         glyph_sink_t* sink)
+{
+	ASSERT(pb);
+	ASSERT(sink);
+
+	// the points are already placed by the sink
+	int c = 0;
+	int i;
+	for(i = 0; i < sink->np; ++i)
+	{
+		int first = 0;
+		if((c < sink->nc) && (sink->contours[c] == i))
+		{
+			first = 1;
+			++c;
+		}
+
+		if(vkk_vgPolygonBuilder_point(pb, first,
+		                              sink->xy[2*i],
+		                              sink->xy[2*i + 1]) == 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_polygon_H
+#define glyph_polygon_H
+
+#include "libvkk/vkk_vg.h"
+#include "glyph_object.h"
+#include "glyph_stats.h"
+
+// The polygon functions are the vkk_vg consumer of the glyph
+// core. The points are forwarded from a callback sink to
+// the polygon builder which tessellates them with libtess2.
+//
+// glyph_polygon_build returns the statistics to the caller
+// rather than storing them in the glyph.
+// glyph_polygon_append appends the points of a point buffer
+// sink (e.g. a glyph placed into a text run) to the builder
+// of a shared polygon.
+
+vkk_vgPolygon_t* glyph_polygon_build(glyph_object_t* glyph,
+                                     vkk_vgPolygonBuilder_t* pb,
+                                     int steps,
+                                     int thresh,
+                                     int flags,
+                                     glyph_stats_t* stats);
+int              glyph_polygon_append(vkk_vgPolygonBuilder_t* pb,
+                                      glyph_sink_t* sink);
+
+#endif
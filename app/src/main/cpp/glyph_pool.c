@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_bezier.h"
+#include "glyph_pool.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct glyph_poolWorker_s
+{
+	glyph_pool_t*           pool;
+	vkk_vgPolygonBuilder_t* pb;
+	pthread_t               thread;
+
+	// job being built
+	glyph_poolJob_t* job;
+} glyph_poolWorker_t;
+
+static int glyph_pool_threads(void)
+{
+	#ifdef GLYPH_POOL_THREADS
+	int threads = GLYPH_POOL_THREADS;
+	#else
+	// leave a core for the render thread
+	int threads = (int) sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	#endif
+
+	if(threads > GLYPH_POOL_MAX_THREADS)
+	{
+		threads = GLYPH_POOL_MAX_THREADS;
+	}
+
+	return (threads > 1) ? threads : 1;
+}
+
+static int
+glyph_pool_match(glyph_poolJob_t* job,
+                 glyph_object_t* glyph,
+                 int steps, int thresh, int flags)
+{
+	ASSERT(glyph);
+
+	return job                      &&
+	       (job->glyph  == glyph)   &&
+	       (job->steps  == steps)   &&
+	       (job->thresh == thresh)  &&
+	       (job->flags  == flags);
+}
+
+static void
+glyph_pool_cancelLocked(glyph_pool_t* self,
+                        glyph_object_t* glyph)
+{
+	ASSERT(self);
+
+	// cancel the pending jobs of the glyph or every pending
+	// job when glyph is NULL
+	glyph_poolJob_t*  job   = self->pending_head;
+	glyph_poolJob_t** _prev = &self->pending_head;
+	self->pending_tail = NULL;
+	while(job)
+	{
+		if((glyph == NULL) || (job->glyph == glyph))
+		{
+			*_prev = job->next;
+			glyph_poolJob_delete(&job);
+			job = *_prev;
+
+			self->cancelled += 1;
+		}
+		else
+		{
+			self->pending_tail = job;
+			_prev = &job->next;
+			job   = job->next;
+		}
+	}
+}
+
+static void* glyph_pool_workerMain(void* arg)
+{
+	ASSERT(arg);
+
+	glyph_poolWorker_t* worker = (glyph_poolWorker_t*) arg;
+	glyph_pool_t*       pool   = worker->pool;
+
+	pthread_mutex_lock(&pool->mutex);
+	while(1)
+	{
+		while((pool->shutdown == 0) &&
+		      (pool->pending_head == NULL))
+		{
+			pthread_cond_wait(&pool->cond, &pool->mutex);
+		}
+
+		if(pool->shutdown)
+		{
+			break;
+		}
+
+		glyph_poolJob_t* job = pool->pending_head;
+		pool->pending_head = job->next;
+		if(pool->pending_head == NULL)
+		{
+			pool->pending_tail = NULL;
+		}
+		job->next   = NULL;
+		worker->job = job;
+		pthread_mutex_unlock(&pool->mutex);
+
+		job->poly = glyph_polygon_build(job->glyph,
+		                                worker->pb,
+		                                job->steps,
+		                                job->thresh,
+		                                job->flags,
+		                                &job->stats);
+
+		pthread_mutex_lock(&pool->mutex);
+		worker->job = NULL;
+		if(job->poly == NULL)
+		{
+			job->next         = pool->failed_head;
+			pool->failed_head = job;
+			pool->failed     += 1;
+			continue;
+		}
+
+		if(pool->done_tail)
+		{
+			pool->done_tail->next = job;
+		}
+		else
+		{
+			pool->done_head = job;
+		}
+		pool->done_tail  = job;
+		pool->completed += 1;
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return NULL;
+}
+
+static void glyph_pool_stop(glyph_pool_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	self->shutdown = 1;
+	glyph_pool_cancelLocked(self, NULL);
+	pthread_cond_broadcast(&self->cond);
+	pthread_mutex_unlock(&self->mutex);
+
+	int i;
+	for(i = 0; i < self->threads; ++i)
+	{
+		pthread_join(self->workers[i].thread, NULL);
+	}
+	self->threads = 0;
+
+	glyph_poolJob_t* job = glyph_pool_collect(self);
+	while(job)
+	{
+		glyph_poolJob_delete(&job);
+		job = glyph_pool_collect(self);
+	}
+
+	job = self->failed_head;
+	while(job)
+	{
+		self->failed_head = job->next;
+		glyph_poolJob_delete(&job);
+		job = self->failed_head;
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_pool_t* glyph_pool_new(vkk_engine_t* engine)
+{
+	glyph_pool_t* self;
+	self = (glyph_pool_t*)
+	       CALLOC(1, sizeof(glyph_pool_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(pthread_mutex_init(&self->mutex, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		goto fail_mutex;
+	}
+
+	if(pthread_cond_init(&self->cond, NULL) != 0)
+	{
+		LOGE("pthread_cond_init failed");
+		goto fail_cond;
+	}
+
+	// select the bezier kernel before the workers start
+	// since the selection is not thread safe
+	glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+
+	self->count   = glyph_pool_threads();
+	self->workers = (glyph_poolWorker_t*)
+	                CALLOC(self->count,
+	                       sizeof(glyph_poolWorker_t));
+	if(self->workers == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_workers;
+	}
+
+	int i;
+	for(i = 0; i < self->count; ++i)
+	{
+		glyph_poolWorker_t* worker = &self->workers[i];
+
+		worker->pool = self;
+		worker->pb   = vkk_vgPolygonBuilder_new(engine);
+		if(worker->pb == NULL)
+		{
+			goto fail_pb;
+		}
+	}
+
+	for(i = 0; i < self->count; ++i)
+	{
+		glyph_poolWorker_t* worker = &self->workers[i];
+		if(pthread_create(&worker->thread, NULL,
+		                  glyph_pool_workerMain,
+		                  (void*) worker) != 0)
+		{
+			LOGE("pthread_create failed");
+			goto fail_thread;
+		}
+		++self->threads;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_thread:
+		glyph_pool_stop(self);
+	fail_pb:
+		for(i = 0; i < self->count; ++i)
+		{
+			vkk_vgPolygonBuilder_delete(&self->workers[i].pb);
+		}
+		FREE(self->workers);
+	fail_workers:
+		pthread_cond_destroy(&self->cond);
+	fail_cond:
+		pthread_mutex_destroy(&self->mutex);
+	fail_mutex:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_pool_delete(glyph_pool_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_pool_t* self = *_self;
+	if(self)
+	{
+		glyph_pool_stop(self);
+
+		int i;
+		for(i = 0; i < self->count; ++i)
+		{
+			vkk_vgPolygonBuilder_delete(&self->workers[i].pb);
+		}
+		FREE(self->workers);
+
+		pthread_cond_destroy(&self->cond);
+		pthread_mutex_destroy(&self->mutex);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_pool_submit(glyph_pool_t* self,
+                      glyph_object_t* glyph,
+                      int steps, int thresh, int flags)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	glyph_poolJob_t* job;
+	job = (glyph_poolJob_t*)
+	      CALLOC(1, sizeof(glyph_poolJob_t));
+	if(job == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	job->glyph  = glyph;
+	job->steps  = steps;
+	job->thresh = thresh;
+	job->flags  = flags;
+
+	pthread_mutex_lock(&self->mutex);
+
+	// the job supersedes the pending jobs of the glyph
+	glyph_pool_cancelLocked(self, glyph);
+
+	if(self->pending_tail)
+	{
+		self->pending_tail->next = job;
+	}
+	else
+	{
+		self->pending_head = job;
+	}
+	self->pending_tail = job;
+	self->submitted   += 1;
+
+	pthread_cond_signal(&self->cond);
+	pthread_mutex_unlock(&self->mutex);
+
+	return 1;
+}
+
+int glyph_pool_find(glyph_pool_t* self,
+                    glyph_object_t* glyph,
+                    int steps, int thresh, int flags)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	// find a pending, running or completed job
+	int found = 0;
+	pthread_mutex_lock(&self->mutex);
+
+	glyph_poolJob_t* job = self->pending_head;
+	while(job && (found == 0))
+	{
+		found = glyph_pool_match(job, glyph, steps, thresh, flags);
+		job   = job->next;
+	}
+
+	int i;
+	for(i = 0; (i < self->threads) && (found == 0); ++i)
+	{
+		found = glyph_pool_match(self->workers[i].job, glyph,
+		                         steps, thresh, flags);
+	}
+
+	job = self->done_head;
+	while(job && (found == 0))
+	{
+		found = glyph_pool_match(job, glyph, steps, thresh, flags);
+		job   = job->next;
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return found;
+}
+
+int glyph_pool_failed(glyph_pool_t* self,
+                      glyph_object_t* glyph,
+                      int steps, int thresh, int flags)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	int found = 0;
+	pthread_mutex_lock(&self->mutex);
+
+	glyph_poolJob_t* job = self->failed_head;
+	while(job && (found == 0))
+	{
+		found = glyph_pool_match(job, glyph, steps, thresh, flags);
+		job   = job->next;
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return found;
+}
+
+void glyph_pool_cancel(glyph_pool_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	glyph_pool_cancelLocked(self, NULL);
+	pthread_mutex_unlock(&self->mutex);
+}
+
+glyph_poolJob_t* glyph_pool_collect(glyph_pool_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+
+	glyph_poolJob_t* job = self->done_head;
+	if(job)
+	{
+		self->done_head = job->next;
+		if(self->done_head == NULL)
+		{
+			self->done_tail = NULL;
+		}
+		job->next = NULL;
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return job;
+}
+
+void glyph_pool_dump(glyph_pool_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	LOGI("POOL: threads=%i, submitted=%i, cancelled=%i, completed=%i, failed=%i",
+	     self->threads, self->submitted, self->cancelled,
+	     self->completed, self->failed);
+	pthread_mutex_unlock(&self->mutex);
+}
+
+void glyph_poolJob_delete(glyph_poolJob_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_poolJob_t* self = *_self;
+	if(self)
+	{
+		vkk_vgPolygon_delete(&self->poly);
+		FREE(self);
+		*_self = NULL;
+	}
+}
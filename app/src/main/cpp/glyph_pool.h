@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_pool_H
+#define glyph_pool_H
+
+#include <pthread.h>
+
+#include "libvkk/vkk.h"
+#include "libvkk/vkk_vg.h"
+#include "glyph_object.h"
+#include "glyph_polygon.h"
+#include "glyph_stats.h"
+
+// The pool builds glyph polygons on worker threads which
+// each own a polygon builder so that the subdivision and
+// tessellation do not stall the render thread. A worker's
+// polygon builder is only used by the worker's thread since
+// vkk_vgPolygonBuilder is not thread safe (the render thread
+// uses its own builder). Jobs are submitted and collected by
+// the render thread. A pending job is cancelled when a newer
+// job is submitted for the same glyph (e.g. a threshold
+// change) or when the pending jobs are cancelled (e.g. a
+// glyph change). Glyphs must be prepared (see
+// glyph_object_prepare) before they are submitted so that
+// the workers only read them.
+//
+// Failed builds are deterministic so the worker keeps the
+// failed jobs rather than completing them and
+// glyph_pool_failed reports the parameters which failed so
+// that they are not resubmitted every frame.
+
+// GLYPH_POOL_THREADS may be defined to override the number
+// of worker threads
+#define GLYPH_POOL_MAX_THREADS 4
+
+typedef struct glyph_poolJob_s
+{
+	glyph_object_t* glyph;
+	int             steps;
+	int             thresh;
+	int             flags;
+
+	// polygon and statistics of the build where the polygon
+	// is owned by the job until it is collected
+	vkk_vgPolygon_t* poly;
+	glyph_stats_t    stats;
+
+	struct glyph_poolJob_s* next;
+} glyph_poolJob_t;
+
+typedef struct glyph_pool_s
+{
+	int                         count;
+	int                         threads;
+	struct glyph_poolWorker_s* workers;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	int             shutdown;
+
+	// pending and completed jobs in FIFO order
+	glyph_poolJob_t* pending_head;
+	glyph_poolJob_t* pending_tail;
+	glyph_poolJob_t* done_head;
+	glyph_poolJob_t* done_tail;
+	glyph_poolJob_t* failed_head;
+
+	int submitted;
+	int cancelled;
+	int completed;
+	int failed;
+} glyph_pool_t;
+
+glyph_pool_t*    glyph_pool_new(vkk_engine_t* engine);
+void             glyph_pool_delete(glyph_pool_t** _self);
+int              glyph_pool_submit(glyph_pool_t* self,
+                                   glyph_object_t* glyph,
+                                   int steps,
+                                   int thresh,
+                                   int flags);
+int              glyph_pool_find(glyph_pool_t* self,
+                                 glyph_object_t* glyph,
+                                 int steps,
+                                 int thresh,
+                                 int flags);
+int              glyph_pool_failed(glyph_pool_t* self,
+                                   glyph_object_t* glyph,
+                                   int steps,
+                                   int thresh,
+                                   int flags);
+void             glyph_pool_cancel(glyph_pool_t* self);
+glyph_poolJob_t* glyph_pool_collect(glyph_pool_t* self);
+void             glyph_pool_dump(glyph_pool_t* self);
+void             glyph_poolJob_delete(glyph_poolJob_t** _self);
+
+#endif
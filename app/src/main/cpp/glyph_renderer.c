@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_renderer.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_renderer_updateVertices(glyph_renderer_t* self,
+                              glyph_arena_t* arena)
+{
+	ASSERT(self);
+	ASSERT(arena);
+
+	// the GPU copy is current unless the arena wrote below
+	// its top since the last upload
+	if(self->vb &&
+	   (arena->dirty_vertices >= arena->top_vertices) &&
+	   (arena->dirty_indices  >= arena->top_indices))
+	{
+		return 1;
+	}
+
+	// the index buffer may refer to moved meshes
+	vkk_buffer_delete(&self->ib);
+	vkk_buffer_delete(&self->vb);
+
+	self->vb = vkk_buffer_new(self->engine,
+	                          VKK_UPDATE_MODE_STATIC,
+	                          VKK_BUFFER_USAGE_VERTEX,
+	                          2*arena->top_vertices*sizeof(float),
+	                          arena->vertices);
+	if(self->vb == NULL)
+	{
+		return 0;
+	}
+
+	glyph_arena_clean(arena);
+	++self->vb_uploads;
+
+	return 1;
+}
+
+static int
+glyph_renderer_updateIndices(glyph_renderer_t* self,
+                             glyph_arena_t* arena,
+                             glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(arena);
+	ASSERT(mesh);
+
+	if(self->ib &&
+	   (self->ib_vb == mesh->vb) &&
+	   (self->ib_ib == mesh->ib) &&
+	   (self->ib_ic == mesh->ic))
+	{
+		return 1;
+	}
+
+	vkk_buffer_delete(&self->ib);
+
+	if(mesh->ic > self->max_indices)
+	{
+		uint32_t* indices;
+		indices = (uint32_t*)
+		          REALLOC(self->indices,
+		                  mesh->ic*sizeof(uint32_t));
+		if(indices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->indices     = indices;
+		self->max_indices = mesh->ic;
+	}
+
+	// apply the vertex offset of the mesh
+	uint16_t* src = glyph_arena_indices(arena, mesh);
+
+	uint32_t i;
+	for(i = 0; i < mesh->ic; ++i)
+	{
+		self->indices[i] = mesh->vb + ((uint32_t) src[i]);
+	}
+
+	self->ib = vkk_buffer_new(self->engine,
+	                          VKK_UPDATE_MODE_STATIC,
+	                          VKK_BUFFER_USAGE_INDEX,
+	                          mesh->ic*sizeof(uint32_t),
+	                          self->indices);
+	if(self->ib == NULL)
+	{
+		return 0;
+	}
+
+	self->ib_vb = mesh->vb;
+	self->ib_ib = mesh->ib;
+	self->ib_ic = mesh->ic;
+	++self->ib_uploads;
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_renderer_t* glyph_renderer_new(vkk_engine_t* engine)
+{
+	ASSERT(engine);
+
+	glyph_renderer_t* self;
+	self = (glyph_renderer_t*)
+	       CALLOC(1, sizeof(glyph_renderer_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->engine = engine;
+
+	vkk_uniformBinding_t ub_array[] =
+	{
+		// layout(std140, set=0, binding=0) uniform uniformMvp
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_BUFFER,
+			.stage   = VKK_STAGE_VS,
+		},
+		// layout(std140, set=0, binding=1) uniform uniformColor
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_BUFFER,
+			.stage   = VKK_STAGE_FS,
+		},
+	};
+
+	self->usf0_mvp_color =
+		vkk_uniformSetFactory_new(engine,
+		                          VKK_UPDATE_MODE_ASYNCHRONOUS,
+		                          2, ub_array);
+	if(self->usf0_mvp_color == NULL)
+	{
+		goto fail_usf0;
+	}
+
+	self->pl = vkk_pipelineLayout_new(engine, 1,
+	                                  &self->usf0_mvp_color);
+	if(self->pl == NULL)
+	{
+		goto fail_pl;
+	}
+
+	vkk_vertexBufferInfo_t vbi =
+	{
+		.location   = 0,
+		.components = 2,
+		.format     = VKK_VERTEX_FORMAT_FLOAT,
+	};
+
+	vkk_graphicsPipelineInfo_t gpi =
+	{
+		.renderer          = vkk_engine_defaultRenderer(engine),
+		.pl                = self->pl,
+		.vs                = "glyph/shaders/mesh_vert.spv",
+		.fs                = "glyph/shaders/mesh_frag.spv",
+		.vb_count          = 1,
+		.vbi               = &vbi,
+		.primitive         = VKK_PRIMITIVE_TRIANGLE_LIST,
+		.primitive_restart = 0,
+		.cull_back         = 0,
+		.depth_test        = 0,
+		.depth_write       = 0,
+		.blend_mode        = VKK_BLEND_MODE_TRANSPARENCY,
+	};
+
+	self->gp = vkk_graphicsPipeline_new(engine, &gpi);
+	if(self->gp == NULL)
+	{
+		goto fail_gp;
+	}
+
+	self->ub00_mvp = vkk_buffer_new(engine,
+	                                VKK_UPDATE_MODE_ASYNCHRONOUS,
+	                                VKK_BUFFER_USAGE_UNIFORM,
+	                                sizeof(cc_mat4f_t), NULL);
+	if(self->ub00_mvp == NULL)
+	{
+		goto fail_ub00;
+	}
+
+	self->ub01_color = vkk_buffer_new(engine,
+	                                  VKK_UPDATE_MODE_ASYNCHRONOUS,
+	                                  VKK_BUFFER_USAGE_UNIFORM,
+	                                  sizeof(cc_vec4f_t), NULL);
+	if(self->ub01_color == NULL)
+	{
+		goto fail_ub01;
+	}
+
+	vkk_uniformAttachment_t ua_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_BUFFER,
+			.buffer  = self->ub00_mvp,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_BUFFER,
+			.buffer  = self->ub01_color,
+		},
+	};
+
+	self->us0_mvp_color = vkk_uniformSet_new(engine, 0, 2,
+	                                         ua_array,
+	                                         self->usf0_mvp_color);
+	if(self->us0_mvp_color == NULL)
+	{
+		goto fail_us0;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_us0:
+		vkk_buffer_delete(&self->ub01_color);
+	fail_ub01:
+		vkk_buffer_delete(&self->ub00_mvp);
+	fail_ub00:
+		vkk_graphicsPipeline_delete(&self->gp);
+	fail_gp:
+		vkk_pipelineLayout_delete(&self->pl);
+	fail_pl:
+		vkk_uniformSetFactory_delete(&self->usf0_mvp_color);
+	fail_usf0:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_renderer_delete(glyph_renderer_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_renderer_t* self = *_self;
+	if(self)
+	{
+		FREE(self->indices);
+		vkk_buffer_delete(&self->ib);
+		vkk_buffer_delete(&self->vb);
+		vkk_uniformSet_delete(&self->us0_mvp_color);
+		vkk_buffer_delete(&self->ub01_color);
+		vkk_buffer_delete(&self->ub00_mvp);
+		vkk_graphicsPipeline_delete(&self->gp);
+		vkk_pipelineLayout_delete(&self->pl);
+		vkk_uniformSetFactory_delete(&self->usf0_mvp_color);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_renderer_draw(glyph_renderer_t* self,
+                        glyph_arena_t* arena,
+                        glyph_arenaMesh_t* mesh,
+                        cc_mat4f_t* mvp,
+                        cc_vec4f_t* color)
+{
+	ASSERT(self);
+	ASSERT(arena);
+	ASSERT(mesh);
+	ASSERT(mvp);
+	ASSERT(color);
+
+	if(mesh->ic == 0)
+	{
+		return 1;
+	}
+
+	if((glyph_renderer_updateVertices(self, arena) == 0) ||
+	   (glyph_renderer_updateIndices(self, arena, mesh) == 0))
+	{
+		return 0;
+	}
+
+	vkk_renderer_t* rend;
+	rend = vkk_engine_defaultRenderer(self->engine);
+
+	vkk_renderer_bindGraphicsPipeline(rend, self->gp);
+	vkk_renderer_updateBuffer(rend, self->ub00_mvp,
+	                          sizeof(cc_mat4f_t),
+	                          (const void*) mvp);
+	vkk_renderer_updateBuffer(rend, self->ub01_color,
+	                          sizeof(cc_vec4f_t),
+	                          (const void*) color);
+	vkk_renderer_bindUniformSets(rend, 1,
+	                             &self->us0_mvp_color);
+	vkk_renderer_drawIndexed(rend, mesh->ic, 1,
+	                         VKK_INDEX_TYPE_UINT,
+	                         self->ib, &self->vb);
+	++self->draws;
+
+	return 1;
+}
+
+void glyph_renderer_dump(glyph_renderer_t* self)
+{
+	ASSERT(self);
+
+	LOGI("RENDERER: vb_uploads=%i, ib_uploads=%i, draws=%i",
+	     self->vb_uploads, self->ib_uploads, self->draws);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_renderer_H
+#define glyph_renderer_H
+
+#include <stdint.h>
+
+#include "libcc/math/cc_mat4f.h"
+#include "libcc/math/cc_vec4f.h"
+#include "libvkk/vkk.h"
+#include "glyph_arena.h"
+
+// The mesh renderer draws the meshes of a mesh arena (see
+// glyph_arena.h) which were built by the glyph tessellator
+// since vkk_vg only draws the polygons which it tessellated
+// with libtess2. The vertex buffer is a GPU copy of the
+// arena vertex buffer which is shared by every mesh and is
+// recreated when the dirty offsets of the arena show that
+// it was modified. The indices of a mesh are relative to
+// its first vertex but vkk_renderer_drawIndexed does not
+// accept a vertex offset so the offset is added when the
+// indices of the mesh are copied to the index buffer. The
+// index buffer is retained until a different mesh is drawn
+// or the arena is modified.
+//
+// The shaders are built by build-resource.sh from
+// resource/glyph/shaders.
+
+typedef struct glyph_renderer_s
+{
+	vkk_engine_t* engine;
+
+	vkk_uniformSetFactory_t* usf0_mvp_color;
+	vkk_pipelineLayout_t*    pl;
+	vkk_graphicsPipeline_t*  gp;
+	vkk_buffer_t*            ub00_mvp;
+	vkk_buffer_t*            ub01_color;
+	vkk_uniformSet_t*        us0_mvp_color;
+
+	// GPU copy of the arena vertex buffer
+	vkk_buffer_t* vb;
+
+	// indices of the mesh in the index buffer
+	uint32_t      ib_vb;
+	uint32_t      ib_ib;
+	uint32_t      ib_ic;
+	vkk_buffer_t* ib;
+	uint32_t      max_indices;
+	uint32_t*     indices;
+
+	// statistics
+	int vb_uploads;
+	int ib_uploads;
+	int draws;
+} glyph_renderer_t;
+
+glyph_renderer_t* glyph_renderer_new(vkk_engine_t* engine);
+void              glyph_renderer_delete(glyph_renderer_t** _self);
+int               glyph_renderer_draw(glyph_renderer_t* self,
+                                      glyph_arena_t* arena,
+                                      glyph_arenaMesh_t* mesh,
+                                      cc_mat4f_t* mvp,
+                                      cc_vec4f_t* color);
+void              glyph_renderer_dump(glyph_renderer_t* self);
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "glyph"
+#include "libbfs/bfs_file.h"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_resource.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_resource_map(glyph_resource_t* self, const char* fname)
+{
+	ASSERT(self);
+	ASSERT(fname);
+
+	int fd = open(fname, O_RDONLY);
+	if(fd < 0)
+	{
+		// loose files are optional
+		return 0;
+	}
+
+	struct stat st;
+	if((fstat(fd, &st) < 0) || (st.st_size <= 0))
+	{
+		LOGE("invalid fname=%s", fname);
+		goto fail_stat;
+	}
+
+	void* map = mmap(NULL, (size_t) st.st_size, PROT_READ,
+	                 MAP_PRIVATE, fd, 0);
+	if(map == MAP_FAILED)
+	{
+		LOGE("mmap failed fname=%s", fname);
+		goto fail_stat;
+	}
+
+	// resources are read front to back
+	madvise(map, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+	// the mapping remains valid after close
+	close(fd);
+
+	self->map  = map;
+	self->data = (const char*) map;
+	self->size = (size_t) st.st_size;
+
+	// success
+	return 1;
+
+	// failure
+	fail_stat:
+		close(fd);
+	return 0;
+}
+
+static int
+glyph_resource_pin(glyph_resource_t* self,
+                   const char* path, const char* name)
+{
+	ASSERT(self);
+	ASSERT(path);
+	ASSERT(name);
+
+	char resource[256];
+	snprintf(resource, 256, "%s/resource.bfs", path);
+
+	bfs_file_t* bfs;
+	bfs = bfs_file_open(resource, 1, BFS_MODE_RDONLY);
+	if(bfs == NULL)
+	{
+		return 0;
+	}
+
+	// libbfs only exposes a copying read so the blob is
+	// pinned in a buffer owned by the resource
+	size_t size = 0;
+	void*  buf  = NULL;
+	if(bfs_file_blobGet(bfs, 0, name, &size, &buf) == 0)
+	{
+		goto fail_blob;
+	}
+
+	if((buf == NULL) || (size == 0))
+	{
+		LOGE("invalid name=%s", name);
+		goto fail_size;
+	}
+
+	bfs_file_close(&bfs);
+
+	self->buf  = buf;
+	self->data = (const char*) buf;
+	self->size = size;
+
+	// success
+	return 1;
+
+	// failure
+	fail_size:
+		FREE(buf);
+	fail_blob:
+		bfs_file_close(&bfs);
+	return 0;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_resource_t*
+glyph_resource_open(const char* path, const char* name)
+{
+	ASSERT(path);
+	ASSERT(name);
+
+	glyph_resource_t* self;
+	self = (glyph_resource_t*)
+	       CALLOC(1, sizeof(glyph_resource_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	// prefer files stored next to resource.bfs
+	char fname[256];
+	snprintf(fname, 256, "%s/%s", path, name);
+	if(glyph_resource_map(self, fname))
+	{
+		return self;
+	}
+
+	if(glyph_resource_pin(self, path, name))
+	{
+		return self;
+	}
+
+	FREE(self);
+	return NULL;
+}
+
+glyph_resource_t* glyph_resource_openFile(const char* fname)
+{
+	ASSERT(fname);
+
+	glyph_resource_t* self;
+	self = (glyph_resource_t*)
+	       CALLOC(1, sizeof(glyph_resource_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(glyph_resource_map(self, fname) == 0)
+	{
+		LOGE("invalid fname=%s", fname);
+		FREE(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void glyph_resource_close(glyph_resource_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_resource_t* self = *_self;
+	if(self)
+	{
+		if(self->map)
+		{
+			munmap(self->map, self->size);
+		}
+		FREE(self->buf);
+		FREE(self);
+		*_self = NULL;
+	}
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_resource_H
+#define glyph_resource_H
+
+#include <stddef.h>
+
+// A resource is a read-only view of a named file which is
+// borrowed until the resource is closed. Files stored next
+// to resource.bfs are memory mapped and otherwise the blob
+// is read from resource.bfs into a pinned buffer.
+
+typedef struct glyph_resource_s
+{
+	const char* data;
+	size_t      size;
+
+	// mapped pages or pinned buffer
+	void* map;
+	void* buf;
+} glyph_resource_t;
+
+glyph_resource_t* glyph_resource_open(const char* path,
+                                      const char* name);
+glyph_resource_t* glyph_resource_openFile(const char* fname);
+void              glyph_resource_close(glyph_resource_t** _self);
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_sink.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_sink_reserve(glyph_sink_t* self, int first, int count)
+{
+	ASSERT(self);
+
+	int np = self->np + count;
+	if(np > self->max_points)
+	{
+		int max_points = self->max_points ?
+		                 2*self->max_points : 1024;
+		while(max_points < np)
+		{
+			max_points *= 2;
+		}
+
+		float* xy;
+		xy = (float*) REALLOC(self->xy,
+		                      2*max_points*sizeof(float));
+		if(xy == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->xy         = xy;
+		self->max_points = max_points;
+	}
+
+	if(first || (self->nc == 0))
+	{
+		if(self->nc >= self->max_contours)
+		{
+			int max_contours = self->max_contours ?
+			                   2*self->max_contours : 16;
+
+			int* contours;
+			contours = (int*)
+			           REALLOC(self->contours,
+			                   max_contours*sizeof(int));
+			if(contours == NULL)
+			{
+				LOGE("REALLOC failed");
+				return 0;
+			}
+
+			self->contours     = contours;
+			self->max_contours = max_contours;
+		}
+
+		self->contours[self->nc] = self->np;
+		++self->nc;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_sink_t* glyph_sink_new(void* priv,
+                             glyph_sink_pointFn point_fn)
+{
+	glyph_sink_t* self;
+	self = (glyph_sink_t*)
+	       MALLOC(sizeof(glyph_sink_t));
+	if(self == NULL)
+	{
+		LOGE("MALLOC failed");
+		return NULL;
+	}
+
+	glyph_sink_init(self, priv, point_fn);
+
+	return self;
+}
+
+void glyph_sink_delete(glyph_sink_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_sink_t* self = *_self;
+	if(self)
+	{
+		glyph_sink_finish(self);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void glyph_sink_init(glyph_sink_t* self, void* priv,
+                     glyph_sink_pointFn point_fn)
+{
+	ASSERT(self);
+
+	memset((void*) self, 0, sizeof(glyph_sink_t));
+
+	self->priv     = priv;
+	self->point_fn = point_fn;
+	self->s        = 1.0f;
+}
+
+void glyph_sink_finish(glyph_sink_t* self)
+{
+	ASSERT(self);
+
+	FREE(self->contours);
+	FREE(self->xy);
+	self->contours     = NULL;
+	self->xy           = NULL;
+	self->np           = 0;
+	self->max_points   = 0;
+	self->nc           = 0;
+	self->max_contours = 0;
+}
+
+void glyph_sink_reset(glyph_sink_t* self)
+{
+	ASSERT(self);
+
+	self->x  = 0.0f;
+	self->y  = 0.0f;
+	self->s  = 1.0f;
+	self->np = 0;
+	self->nc = 0;
+}
+
+void glyph_sink_place(glyph_sink_t* self,
+                      float x, float y, float s)
+{
+	ASSERT(self);
+
+	self->x = x;
+	self->y = y;
+	self->s = s;
+}
+
+int glyph_sink_point(glyph_sink_t* self, int first,
+                     float x, float y)
+{
+	ASSERT(self);
+
+	if(self->point_fn)
+	{
+		return (*self->point_fn)(self->priv, first,
+		                         self->x + self->s*x,
+		                         self->y + self->s*y);
+	}
+
+	return glyph_sink_points(self, first, 1, &x, &y);
+}
+
+int glyph_sink_points(glyph_sink_t* self, int first,
+                      int count,
+                      const float* x,
+                      const float* y)
+{
+	ASSERT(self);
+	ASSERT(x);
+	ASSERT(y);
+
+	float sx = self->x;
+	float sy = self->y;
+	float s  = self->s;
+
+	int i;
+	if(self->point_fn)
+	{
+		for(i = 0; i < count; ++i)
+		{
+			if((*self->point_fn)(self->priv, first,
+			                     sx + s*x[i],
+			                     sy + s*y[i]) == 0)
+			{
+				return 0;
+			}
+			first = 0;
+		}
+
+		return 1;
+	}
+
+	if(count <= 0)
+	{
+		return 1;
+	}
+
+	if(glyph_sink_reserve(self, first, count) == 0)
+	{
+		return 0;
+	}
+
+	float* xy = &self->xy[2*self->np];
+	for(i = 0; i < count; ++i)
+	{
+		xy[2*i]     = sx + s*x[i];
+		xy[2*i + 1] = sy + s*y[i];
+	}
+	self->np += count;
+
+	return 1;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_sink_H
+#define glyph_sink_H
+
+// The point sink receives the points of the subdivided glyph
+// outlines so that the glyph core does not depend on a
+// particular consumer. A sink either stores the points in a
+// point buffer (e.g. for the glyph tessellator) or forwards
+// each point to a callback (e.g. for a polygon builder).
+// Points are written in bulk per segment and the first flag
+// starts a new contour. The placement (x,y,s) is applied to
+// every point as (x + s*px, y + s*py) so that glyphs may be
+// placed into a shared polygon (e.g. a text run).
+
+typedef int (*glyph_sink_pointFn)(void* priv, int first,
+                                  float x, float y);
+
+typedef struct glyph_sink_s
+{
+	// optional callback which replaces the point buffer
+	void*              priv;
+	glyph_sink_pointFn point_fn;
+
+	// placement
+	float x;
+	float y;
+	float s;
+
+	// point buffer (x,y) and contour starts
+	int    np;
+	int    max_points;
+	float* xy;
+	int    nc;
+	int    max_contours;
+	int*   contours;
+} glyph_sink_t;
+
+glyph_sink_t* glyph_sink_new(void* priv,
+                             glyph_sink_pointFn point_fn);
+void          glyph_sink_delete(glyph_sink_t** _self);
+void          glyph_sink_init(glyph_sink_t* self, void* priv,
+                              glyph_sink_pointFn point_fn);
+void          glyph_sink_finish(glyph_sink_t* self);
+void          glyph_sink_reset(glyph_sink_t* self);
+void          glyph_sink_place(glyph_sink_t* self,
+                               float x, float y, float s);
+int           glyph_sink_point(glyph_sink_t* self, int first,
+                               float x, float y);
+int           glyph_sink_points(glyph_sink_t* self, int first,
+                                int count,
+                                const float* x,
+                                const float* y);
+
+#endif
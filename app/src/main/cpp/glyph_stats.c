@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "glyph_stats.h"
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+void glyph_stats_reset(glyph_stats_t* self)
+{
+	ASSERT(self);
+
+	memset((void*) self, 0, sizeof(glyph_stats_t));
+}
+
+void glyph_stats_segment(glyph_stats_t* self, int steps)
+{
+	ASSERT(self);
+
+	int i = 0;
+	while((i < GLYPH_STATS_BUCKETS - 1) && ((2 << i) <= steps))
+	{
+		++i;
+	}
+
+	self->segments += 1;
+	self->steps[i] += 1;
+}
+
+void glyph_stats_add(glyph_stats_t* self,
+                     const glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(stats);
+
+	self->builds     += stats->builds;
+	self->skips      += stats->skips;
+	self->lines      += stats->lines;
+	self->segments   += stats->segments;
+	self->points     += stats->points;
+	self->batches    += stats->batches;
+	self->batched    += stats->batched;
+	self->err        += stats->err;
+	self->build_time += stats->build_time;
+	self->tess_time  += stats->tess_time;
+
+	int i;
+	for(i = 0; i < GLYPH_STATS_BUCKETS; ++i)
+	{
+		self->steps[i] += stats->steps[i];
+	}
+}
+
+void glyph_stats_dump(const glyph_stats_t* self,
+                      const char* name)
+{
+	ASSERT(self);
+	ASSERT(name);
+
+	LOGI("STATS(%s): builds=%i, skips=%i, lines=%i, segments=%i, points=%i, err=%f",
+	     name, self->builds, self->skips, self->lines,
+	     self->segments, self->points, self->err);
+	LOGI("STATS(%s): steps 1=%i, 2=%i, 4=%i, 8=%i, 16=%i",
+	     name, self->steps[0], self->steps[1], self->steps[2],
+	     self->steps[3], self->steps[4]);
+	LOGI("STATS(%s): batches=%i, batched=%i",
+	     name, self->batches, self->batched);
+	LOGI("STATS(%s): build_time=%lf, tess_time=%lf",
+	     name, self->build_time, self->tess_time);
+}
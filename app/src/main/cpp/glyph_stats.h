@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef glyph_stats_H
+#define glyph_stats_H
+
+// Build statistics are collected per glyph build and may be
+// accumulated across builds. The curved segments are counted
+// per bucket of subdivision steps where bucket i counts the
+// segments subdivided into [2^i, 2^(i+1)) steps (or spans
+// for recursive subdivision). The time is in seconds.
+// Skips count the builds which retained the cached polygon
+// since the parameters changed but the points did not or
+// which loaded the mesh from the mesh store.
+// Batches count the Bezier kernel calls of the conic
+// segments and batched counts the conic segments evaluated
+// by those calls (e.g. batched/batches is the average batch
+// size).
+
+#define GLYPH_STATS_BUCKETS 5
+
+typedef struct glyph_stats_s
+{
+	int   builds;
+	int   skips;
+	int   lines;
+	int   segments;
+	int   steps[GLYPH_STATS_BUCKETS];
+	int   points;
+	int   batches;
+	int   batched;
+	float err;
+
+	double build_time;
+	double tess_time;
+} glyph_stats_t;
+
+void glyph_stats_reset(glyph_stats_t* self);
+void glyph_stats_segment(glyph_stats_t* self, int steps);
+void glyph_stats_add(glyph_stats_t* self,
+                     const glyph_stats_t* stats);
+void glyph_stats_dump(const glyph_stats_t* self,
+                      const char* name);
+
+#endif
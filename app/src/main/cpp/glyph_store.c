@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_store.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define GLYPH_STORE_HASH_OFFSET 0xCBF29CE484222325ULL
+#define GLYPH_STORE_HASH_PRIME  0x00000100000001B3ULL
+
+static uint64_t
+glyph_store_hash(uint64_t hash, const void* data, size_t size)
+{
+	ASSERT(data || (size == 0));
+
+	// FNV-1a over 64-bit words with a shift to mix the high
+	// bits into the low bits which detects changes to the
+	// content but is not a cryptographic hash
+	const uint8_t* p = (const uint8_t*) data;
+	uint64_t       w;
+	while(size >= 8)
+	{
+		memcpy((void*) &w, (const void*) p, 8);
+		hash  = (hash ^ w)*GLYPH_STORE_HASH_PRIME;
+		hash ^= hash >> 32;
+		p    += 8;
+		size -= 8;
+	}
+
+	while(size > 0)
+	{
+		hash = (hash ^ *p)*GLYPH_STORE_HASH_PRIME;
+		++p;
+		--size;
+	}
+
+	return hash;
+}
+
+static int
+glyph_store_fontHash(glyph_font_t* font, uint64_t* _hash)
+{
+	ASSERT(font);
+	ASSERT(_hash);
+
+	// the hash covers the resource which the font was loaded
+	// from (e.g. the glyph pack) since hashing the outlines
+	// would decode every lazy glyph
+	glyph_resource_t* res = font->pack ? font->pack->res :
+	                                     font->res;
+	if(res)
+	{
+		*_hash = glyph_store_hash(GLYPH_STORE_HASH_OFFSET,
+		                          res->data, res->size);
+		return 1;
+	}
+
+	// the resource is released once every glyph is decoded
+	uint64_t hash = GLYPH_STORE_HASH_OFFSET;
+
+	int i;
+	for(i = 0; i < glyph_font_count(font); ++i)
+	{
+		glyph_object_t* glyph = glyph_font_glyph(font, i);
+		if(glyph == NULL)
+		{
+			return 0;
+		}
+
+		const char* name = glyph_object_name(glyph);
+		int32_t     info[3] =
+		{
+			(int32_t) glyph->code,
+			(int32_t) glyph->np,
+			(int32_t) glyph->nc,
+		};
+		float size[2] = { glyph->w, glyph->h };
+
+		hash = glyph_store_hash(hash, name, strlen(name) + 1);
+		hash = glyph_store_hash(hash, info, sizeof(info));
+		hash = glyph_store_hash(hash, size, sizeof(size));
+		hash = glyph_store_hash(hash, &font->x[glyph->p],
+		                        glyph->np*sizeof(float));
+		hash = glyph_store_hash(hash, &font->y[glyph->p],
+		                        glyph->np*sizeof(float));
+		hash = glyph_store_hash(hash, &font->t[glyph->p],
+		                        glyph->np*sizeof(uint8_t));
+		hash = glyph_store_hash(hash, &font->c[glyph->c],
+		                        glyph->nc*sizeof(int32_t));
+	}
+
+	*_hash = hash;
+	return 1;
+}
+
+static void
+glyph_store_name(glyph_store_t* self, glyph_object_t* glyph,
+                 int steps, int thresh, int flags,
+                 char* name)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(name);
+
+	snprintf(name, 256, "mesh-%016" PRIx64 "-v%i-%i-%i-%i-%s",
+	         self->hash, GLYPH_STORE_VERSION, steps, thresh,
+	         flags, glyph_object_name(glyph));
+}
+
+static size_t
+glyph_store_size(uint32_t vc, uint32_t ic)
+{
+	return sizeof(glyph_storeHeader_t) +
+	       2*vc*sizeof(float) + ic*sizeof(uint16_t);
+}
+
+static int
+glyph_store_validate(glyph_store_t* self,
+                     const void* data, size_t size,
+                     int steps, int thresh, int flags)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	if(size < sizeof(glyph_storeHeader_t))
+	{
+		return 0;
+	}
+
+	const glyph_storeHeader_t* header;
+	header = (const glyph_storeHeader_t*) data;
+	if((header->magic   != GLYPH_STORE_MAGIC)   ||
+	   (header->version != GLYPH_STORE_VERSION) ||
+	   (header->hash    != self->hash)          ||
+	   (header->steps   != steps)               ||
+	   (header->thresh  != thresh)              ||
+	   (header->flags   != flags))
+	{
+		return 0;
+	}
+
+	// indices are 16-bit
+	uint32_t vc = header->vc;
+	uint32_t ic = header->ic;
+	if((vc == 0) || (vc > GLYPH_ARENA_MAX_MESH_VERTICES) ||
+	   (ic%3) || (size != glyph_store_size(vc, ic)))
+	{
+		return 0;
+	}
+
+	const char* payload = (const char*) (header + 1);
+	if(glyph_store_hash(GLYPH_STORE_HASH_OFFSET, payload,
+	                    size - sizeof(glyph_storeHeader_t)) !=
+	   header->checksum)
+	{
+		return 0;
+	}
+
+	const uint16_t* indices;
+	indices = (const uint16_t*) (payload + 2*vc*sizeof(float));
+
+	uint32_t i;
+	for(i = 0; i < ic; ++i)
+	{
+		if(indices[i] >= vc)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_store_t* glyph_store_new(glyph_font_t* font,
+                               const char* fname,
+                               int writable)
+{
+	ASSERT(font);
+	ASSERT(fname);
+
+	// the blob layout is little-endian
+	uint32_t endian = 1;
+	if(*((uint8_t*) &endian) != 1)
+	{
+		LOGE("big-endian is not supported");
+		return NULL;
+	}
+
+	glyph_store_t* self;
+	self = (glyph_store_t*)
+	       CALLOC(1, sizeof(glyph_store_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(glyph_store_fontHash(font, &self->hash) == 0)
+	{
+		goto fail_open;
+	}
+
+	int mode = writable ? BFS_MODE_RDWR : BFS_MODE_RDONLY;
+	self->bfs = bfs_file_open(fname, 1, mode);
+	if(self->bfs == NULL)
+	{
+		LOGE("invalid fname=%s", fname);
+		goto fail_open;
+	}
+
+	self->writable = writable;
+
+	// success
+	return self;
+
+	// failure
+	fail_open:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_store_delete(glyph_store_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_store_t* self = *_self;
+	if(self)
+	{
+		bfs_file_close(&self->bfs);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_store_load(glyph_store_t* self,
+                     glyph_object_t* glyph,
+                     int steps,
+                     int thresh,
+                     int flags,
+                     glyph_arena_t* arena,
+                     glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(arena);
+	ASSERT(mesh);
+
+	double t0 = cc_timestamp();
+
+	char name[256];
+	glyph_store_name(self, glyph, steps, thresh, flags, name);
+
+	size_t size = 0;
+	void*  data = NULL;
+	if((bfs_file_blobGet(self->bfs, 0, name,
+	                     &size, &data) == 0) ||
+	   (data == NULL) || (size == 0))
+	{
+		FREE(data);
+		++self->misses;
+		return 0;
+	}
+
+	if(glyph_store_validate(self, data, size,
+	                        steps, thresh, flags) == 0)
+	{
+		LOGW("invalid name=%s", name);
+		goto fail_validate;
+	}
+
+	const glyph_storeHeader_t* header;
+	header = (const glyph_storeHeader_t*) data;
+
+	const char* payload = (const char*) (header + 1);
+	if(glyph_arena_alloc(arena, mesh, header->vc,
+	                     header->ic) == 0)
+	{
+		goto fail_alloc;
+	}
+
+	memcpy((void*) glyph_arena_vertices(arena, mesh),
+	       (const void*) payload,
+	       2*header->vc*sizeof(float));
+	memcpy((void*) glyph_arena_indices(arena, mesh),
+	       (const void*) (payload + 2*header->vc*sizeof(float)),
+	       header->ic*sizeof(uint16_t));
+
+	FREE(data);
+
+	++self->hits;
+	self->load_time += cc_timestamp() - t0;
+
+	// success
+	return 1;
+
+	// failure
+	fail_validate:
+		++self->invalid;
+	fail_alloc:
+		FREE(data);
+		++self->misses;
+	return 0;
+}
+
+int glyph_store_save(glyph_store_t* self,
+                     glyph_object_t* glyph,
+                     int steps,
+                     int thresh,
+                     int flags,
+                     glyph_arena_t* arena,
+                     glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(arena);
+	ASSERT(mesh);
+
+	if(self->writable == 0)
+	{
+		LOGE("invalid writable");
+		return 0;
+	}
+
+	size_t size = glyph_store_size(mesh->vc, mesh->ic);
+
+	char* data = (char*) MALLOC(size);
+	if(data == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+
+	glyph_storeHeader_t* header = (glyph_storeHeader_t*) data;
+	char*                payload = (char*) (header + 1);
+	memset((void*) header, 0, sizeof(glyph_storeHeader_t));
+	memcpy((void*) payload,
+	       (const void*) glyph_arena_vertices(arena, mesh),
+	       2*mesh->vc*sizeof(float));
+	memcpy((void*) (payload + 2*mesh->vc*sizeof(float)),
+	       (const void*) glyph_arena_indices(arena, mesh),
+	       mesh->ic*sizeof(uint16_t));
+
+	header->magic    = GLYPH_STORE_MAGIC;
+	header->version  = GLYPH_STORE_VERSION;
+	header->steps    = steps;
+	header->thresh   = thresh;
+	header->flags    = flags;
+	header->vc       = mesh->vc;
+	header->ic       = mesh->ic;
+	header->hash     = self->hash;
+	header->checksum = glyph_store_hash(GLYPH_STORE_HASH_OFFSET,
+	                                    payload,
+	                                    size - sizeof(glyph_storeHeader_t));
+
+	char name[256];
+	glyph_store_name(self, glyph, steps, thresh, flags, name);
+	if(bfs_file_blobSet(self->bfs, 0, name, size,
+	                    (const void*) data) == 0)
+	{
+		goto fail_blob;
+	}
+
+	FREE(data);
+
+	++self->writes;
+
+	// success
+	return 1;
+
+	// failure
+	fail_blob:
+		FREE(data);
+	return 0;
+}
+
+int glyph_store_build(glyph_store_t* self,
+                      glyph_object_t* glyph,
+                      glyph_sink_t* sink,
+                      glyph_tess_t* tess,
+                      glyph_arena_t* arena,
+                      glyph_arenaMesh_t* mesh,
+                      int steps,
+                      int thresh,
+                      int flags,
+                      glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+	ASSERT(sink);
+	ASSERT(tess);
+	ASSERT(arena);
+	ASSERT(mesh);
+	ASSERT(stats);
+
+	glyph_stats_reset(stats);
+
+	// see glyph_object_buildMesh
+	if(glyph->np < 3)
+	{
+		return 0;
+	}
+
+	if(glyph_store_load(self, glyph, steps, thresh, flags,
+	                    arena, mesh))
+	{
+		stats->skips  = 1;
+		stats->points = (int) mesh->vc;
+		return 1;
+	}
+
+	if(glyph_object_buildMesh(glyph, sink, tess, arena, mesh,
+	                          steps, thresh, flags,
+	                          stats) == 0)
+	{
+		return 0;
+	}
+
+	// the mesh is still valid when the write fails
+	if(self->writable)
+	{
+		glyph_store_save(self, glyph, steps, thresh, flags,
+		                 arena, mesh);
+	}
+
+	return 1;
+}
+
+void glyph_store_dump(glyph_store_t* self)
+{
+	ASSERT(self);
+
+	LOGI("STORE: hash=%016" PRIx64 ", hits=%i, misses=%i, invalid=%i, writes=%i, load_time=%lf",
+	     self->hash, self->hits, self->misses, self->invalid,
+	     self->writes, self->load_time);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_store_H
+#define glyph_store_H
+
+#include <stdint.h>
+
+#include "libbfs/bfs_file.h"
+#include "glyph_arena.h"
+#include "glyph_font.h"
+#include "glyph_object.h"
+#include "glyph_sink.h"
+#include "glyph_stats.h"
+#include "glyph_tess.h"
+
+// The mesh store persists the glyph meshes built by the
+// glyph tessellator in a bfs file (e.g. mesh.bfs next to
+// resource.bfs) since a mesh only depends on the outline
+// and the build parameters. Each mesh is stored as a
+// separate blob which is read on the first lookup of the
+// glyph and the blob name is keyed by the content hash of
+// the font resource (or of the outlines when the resource
+// was released), the store version and the build parameters
+// (steps, thresh and flags). GLYPH_STORE_VERSION must be
+// incremented whenever the subdivision or tessellation
+// output changes.
+//
+// Blobs are validated before they are copied into the mesh
+// arena and invalid blobs are treated as misses. When the
+// store is writable the meshes of misses are written back
+// so that the next process may skip the subdivision and
+// tessellation. All fields are little-endian.
+//
+// header
+// xy[2*vc] (float)
+// i[ic]    (uint16_t)
+
+#define GLYPH_STORE_MAGIC   0x53484D47
+#define GLYPH_STORE_VERSION 1
+
+typedef struct glyph_storeHeader_s
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t  steps;
+	int32_t  thresh;
+	int32_t  flags;
+	uint32_t vc;
+	uint32_t ic;
+	uint32_t reserved;
+	uint64_t hash;
+	uint64_t checksum;
+} glyph_storeHeader_t;
+
+typedef struct glyph_store_s
+{
+	bfs_file_t* bfs;
+	int         writable;
+
+	// content hash of the font
+	uint64_t hash;
+
+	// statistics
+	int    hits;
+	int    misses;
+	int    invalid;
+	int    writes;
+	double load_time;
+} glyph_store_t;
+
+glyph_store_t* glyph_store_new(glyph_font_t* font,
+                               const char* fname,
+                               int writable);
+void           glyph_store_delete(glyph_store_t** _self);
+int            glyph_store_load(glyph_store_t* self,
+                                glyph_object_t* glyph,
+                                int steps,
+                                int thresh,
+                                int flags,
+                                glyph_arena_t* arena,
+                                glyph_arenaMesh_t* mesh);
+int            glyph_store_save(glyph_store_t* self,
+                                glyph_object_t* glyph,
+                                int steps,
+                                int thresh,
+                                int flags,
+                                glyph_arena_t* arena,
+                                glyph_arenaMesh_t* mesh);
+int            glyph_store_build(glyph_store_t* self,
+                                 glyph_object_t* glyph,
+                                 glyph_sink_t* sink,
+                                 glyph_tess_t* tess,
+                                 glyph_arena_t* arena,
+                                 glyph_arenaMesh_t* mesh,
+                                 int steps,
+                                 int thresh,
+                                 int flags,
+                                 glyph_stats_t* stats);
+void           glyph_store_dump(glyph_store_t* self);
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph-store"
+#include "libcc/cc_log.h"
+#include "glyph_bezier.h"
+#include "glyph_font.h"
+#include "glyph_store.h"
+
+#define GLYPH_STORE_TOOL_FLAGS (GLYPH_OBJECT_FLAG_ANALYTIC | \
+                                GLYPH_OBJECT_FLAG_FORWARD  | \
+                                GLYPH_OBJECT_FLAG_RECURSIVE)
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+glyph_storeTool_parse(const char* str, const char* name,
+                      long min, long max, int* _val)
+{
+	ASSERT(str);
+	ASSERT(name);
+	ASSERT(_val);
+
+	char* end = NULL;
+	long  val = strtol(str, &end, 0);
+	if((end == str) || (*end != '\0') ||
+	   (val < min)  || (val > max))
+	{
+		LOGE("invalid %s=%s", name, str);
+		return 0;
+	}
+
+	*_val = (int) val;
+
+	return 1;
+}
+
+static glyph_font_t* glyph_storeTool_font(const char* fname)
+{
+	ASSERT(fname);
+
+	// split font.json or font.gpk into the path and name
+	// which are loaded like the app so that the store is
+	// keyed by the same resource (e.g. the glyph pack)
+	char path[256];
+	char name[256];
+	const char* sep = strrchr(fname, '/');
+	if(sep)
+	{
+		snprintf(path, 256, "%.*s", (int) (sep - fname), fname);
+		snprintf(name, 256, "%s", sep + 1);
+	}
+	else
+	{
+		snprintf(path, 256, ".");
+		snprintf(name, 256, "%s", fname);
+	}
+
+	char* ext = strrchr(name, '.');
+	if(ext && ((strcmp(ext, ".json") == 0) ||
+	           (strcmp(ext, ".gpk")  == 0)))
+	{
+		*ext = '\0';
+	}
+
+	return glyph_font_new(path, name, GLYPH_FONT_FLAG_LAZY);
+}
+
+/***********************************************************
+* main                                                     *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	// steps=0 with thresh=0 selects the naive algorithm and
+	// thresh>0 selects ASA which computes its own steps
+	int steps;
+	int thresh;
+	int flags;
+	if((argc != 6) ||
+	   (glyph_storeTool_parse(argv[3], "steps", 0,
+	                          GLYPH_OBJECT_MAX_STEPS,
+	                          &steps) == 0) ||
+	   (glyph_storeTool_parse(argv[4], "thresh", 0,
+	                          INT_MAX, &thresh) == 0) ||
+	   (glyph_storeTool_parse(argv[5], "flags", 0,
+	                          GLYPH_STORE_TOOL_FLAGS,
+	                          &flags) == 0))
+	{
+		LOGE("usage: %s font.[json|gpk] mesh.bfs steps thresh flags",
+		     argv[0]);
+		LOGE("steps: 0 to %i", GLYPH_OBJECT_MAX_STEPS);
+		LOGE("thresh: 0 or more (error/10000)");
+		LOGE("flags: analytic=%i, forward=%i, recursive=%i",
+		     GLYPH_OBJECT_FLAG_ANALYTIC,
+		     GLYPH_OBJECT_FLAG_FORWARD,
+		     GLYPH_OBJECT_FLAG_RECURSIVE);
+		return EXIT_FAILURE;
+	}
+
+	const char* fname_font = argv[1];
+	const char* fname_bfs  = argv[2];
+
+	glyph_bezier_select(GLYPH_BEZIER_KERNEL_AUTO);
+
+	glyph_font_t* font = glyph_storeTool_font(fname_font);
+	if(font == NULL)
+	{
+		return EXIT_FAILURE;
+	}
+
+	glyph_store_t* store = glyph_store_new(font, fname_bfs, 1);
+	if(store == NULL)
+	{
+		goto fail_store;
+	}
+
+	glyph_sink_t* sink = glyph_sink_new(NULL, NULL);
+	if(sink == NULL)
+	{
+		goto fail_sink;
+	}
+
+	glyph_tess_t* tess = glyph_tess_new();
+	if(tess == NULL)
+	{
+		goto fail_tess;
+	}
+
+	glyph_arena_t* arena = glyph_arena_new(0, 0);
+	if(arena == NULL)
+	{
+		goto fail_arena;
+	}
+
+	// the meshes of the glyphs which are not stored yet are
+	// built and written to the store
+	int i;
+	for(i = 0; i < glyph_font_count(font); ++i)
+	{
+		glyph_object_t* glyph = glyph_font_glyph(font, i);
+		if(glyph == NULL)
+		{
+			goto fail_glyph;
+		}
+
+		glyph_arenaMesh_t mesh;
+		glyph_stats_t     stats;
+		if(glyph_store_build(store, glyph, sink, tess, arena,
+		                     &mesh, steps, thresh, flags,
+		                     &stats))
+		{
+			glyph_arena_free(arena, &mesh);
+		}
+	}
+
+	glyph_store_dump(store);
+
+	glyph_arena_delete(&arena);
+	glyph_tess_delete(&tess);
+	glyph_sink_delete(&sink);
+	glyph_store_delete(&store);
+	glyph_font_delete(&font);
+
+	// success
+	return EXIT_SUCCESS;
+
+	// failure
+	fail_glyph:
+		glyph_arena_delete(&arena);
+	fail_arena:
+		glyph_tess_delete(&tess);
+	fail_tess:
+		glyph_sink_delete(&sink);
+	fail_sink:
+		glyph_store_delete(&store);
+	fail_store:
+		glyph_font_delete(&font);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,1239 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "glyph_tess.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// contours with more points use the z-order curve
+#define GLYPH_TESS_ZORDER_POINTS 80
+
+typedef struct glyph_tessNode_s
+{
+	// index of the point
+	uint32_t i;
+
+	// bridge node of a single point hole
+	int steiner;
+
+	double x;
+	double y;
+
+	// ring order
+	struct glyph_tessNode_s* prev;
+	struct glyph_tessNode_s* next;
+
+	// z-order
+	uint32_t                 z;
+	struct glyph_tessNode_s* prevZ;
+	struct glyph_tessNode_s* nextZ;
+} glyph_tessNode_t;
+
+typedef struct glyph_tessContour_s
+{
+	double area;
+	double min_x;
+	double min_y;
+	double max_x;
+	double max_y;
+
+	// nesting depth (outer contours are even) and the
+	// innermost contour which contains the contour
+	int depth;
+	int parent;
+} glyph_tessContour_t;
+
+// z-order bounds of the contours being triangulated
+typedef struct
+{
+	double min_x;
+	double min_y;
+	double inv_size;
+} glyph_tessZ_t;
+
+static glyph_tessNode_t*
+glyph_tess_node(glyph_tess_t* self, uint32_t i)
+{
+	ASSERT(self);
+	ASSERT(self->count_nodes < self->max_nodes);
+
+	glyph_tessNode_t* p = &self->nodes[self->count_nodes++];
+	memset((void*) p, 0, sizeof(glyph_tessNode_t));
+	p->i = i;
+	p->x = (double) self->xy[2*i];
+	p->y = (double) self->xy[2*i + 1];
+
+	return p;
+}
+
+static glyph_tessNode_t*
+glyph_tess_insertNode(glyph_tess_t* self, uint32_t i,
+                      glyph_tessNode_t* last)
+{
+	ASSERT(self);
+
+	glyph_tessNode_t* p = glyph_tess_node(self, i);
+	if(last == NULL)
+	{
+		p->prev = p;
+		p->next = p;
+	}
+	else
+	{
+		p->next          = last->next;
+		p->prev          = last;
+		last->next->prev = p;
+		last->next       = p;
+	}
+
+	return p;
+}
+
+static void glyph_tess_removeNode(glyph_tessNode_t* p)
+{
+	ASSERT(p);
+
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if(p->prevZ)
+	{
+		p->prevZ->nextZ = p->nextZ;
+	}
+
+	if(p->nextZ)
+	{
+		p->nextZ->prevZ = p->prevZ;
+	}
+}
+
+// twice the signed area of the triangle (p, q, r)
+static double
+glyph_tess_area(glyph_tessNode_t* p, glyph_tessNode_t* q,
+                glyph_tessNode_t* r)
+{
+	return (q->y - p->y)*(r->x - q->x) -
+	       (q->x - p->x)*(r->y - q->y);
+}
+
+static int
+glyph_tess_equals(glyph_tessNode_t* p, glyph_tessNode_t* q)
+{
+	return (p->x == q->x) && (p->y == q->y);
+}
+
+static int
+glyph_tess_pointInTriangle(double ax, double ay,
+                           double bx, double by,
+                           double cx, double cy,
+                           double px, double py)
+{
+	return ((cx - px)*(ay - py) >= (ax - px)*(cy - py)) &&
+	       ((ax - px)*(by - py) >= (bx - px)*(ay - py)) &&
+	       ((bx - px)*(cy - py) >= (cx - px)*(by - py));
+}
+
+static int glyph_tess_sign(double v)
+{
+	return (v > 0.0) ? 1 : ((v < 0.0) ? -1 : 0);
+}
+
+// q lies on the segment (p, r) for collinear p, q and r
+static int
+glyph_tess_onSegment(glyph_tessNode_t* p, glyph_tessNode_t* q,
+                     glyph_tessNode_t* r)
+{
+	return (q->x <= fmax(p->x, r->x)) &&
+	       (q->x >= fmin(p->x, r->x)) &&
+	       (q->y <= fmax(p->y, r->y)) &&
+	       (q->y >= fmin(p->y, r->y));
+}
+
+static int
+glyph_tess_intersects(glyph_tessNode_t* p1, glyph_tessNode_t* q1,
+                      glyph_tessNode_t* p2, glyph_tessNode_t* q2)
+{
+	int o1 = glyph_tess_sign(glyph_tess_area(p1, q1, p2));
+	int o2 = glyph_tess_sign(glyph_tess_area(p1, q1, q2));
+	int o3 = glyph_tess_sign(glyph_tess_area(p2, q2, p1));
+	int o4 = glyph_tess_sign(glyph_tess_area(p2, q2, q1));
+
+	if((o1 != o2) && (o3 != o4))
+	{
+		return 1;
+	}
+
+	// collinear cases
+	return ((o1 == 0) && glyph_tess_onSegment(p1, p2, q1)) ||
+	       ((o2 == 0) && glyph_tess_onSegment(p1, q2, q1)) ||
+	       ((o3 == 0) && glyph_tess_onSegment(p2, p1, q2)) ||
+	       ((o4 == 0) && glyph_tess_onSegment(p2, q1, q2));
+}
+
+// the diagonal (a, b) intersects an edge of the ring
+static int
+glyph_tess_intersectsPolygon(glyph_tessNode_t* a,
+                             glyph_tessNode_t* b)
+{
+	glyph_tessNode_t* p = a;
+	do
+	{
+		if((p->i != a->i) && (p->next->i != a->i) &&
+		   (p->i != b->i) && (p->next->i != b->i) &&
+		   glyph_tess_intersects(p, p->next, a, b))
+		{
+			return 1;
+		}
+		p = p->next;
+	} while(p != a);
+
+	return 0;
+}
+
+// the diagonal (a, b) starts inside the ring at a
+static int
+glyph_tess_locallyInside(glyph_tessNode_t* a,
+                         glyph_tessNode_t* b)
+{
+	if(glyph_tess_area(a->prev, a, a->next) < 0.0)
+	{
+		return (glyph_tess_area(a, b, a->next) >= 0.0) &&
+		       (glyph_tess_area(a, a->prev, b) >= 0.0);
+	}
+
+	return (glyph_tess_area(a, b, a->prev) < 0.0) ||
+	       (glyph_tess_area(a, a->next, b) < 0.0);
+}
+
+// the midpoint of the diagonal (a, b) is inside the ring
+static int
+glyph_tess_middleInside(glyph_tessNode_t* a,
+                        glyph_tessNode_t* b)
+{
+	glyph_tessNode_t* p  = a;
+	int               in = 0;
+	double            px = (a->x + b->x)/2.0;
+	double            py = (a->y + b->y)/2.0;
+	do
+	{
+		if(((p->y > py) != (p->next->y > py)) &&
+		   (p->next->y != p->y) &&
+		   (px < (p->next->x - p->x)*(py - p->y)/
+		         (p->next->y - p->y) + p->x))
+		{
+			in = !in;
+		}
+		p = p->next;
+	} while(p != a);
+
+	return in;
+}
+
+static int
+glyph_tess_isValidDiagonal(glyph_tessNode_t* a,
+                           glyph_tessNode_t* b)
+{
+	if((a->next->i == b->i) || (a->prev->i == b->i) ||
+	   glyph_tess_intersectsPolygon(a, b))
+	{
+		return 0;
+	}
+
+	// the diagonal is locally visible and does not create
+	// opposite facing sectors or is a zero length diagonal
+	// between two convex vertices
+	return (glyph_tess_locallyInside(a, b) &&
+	        glyph_tess_locallyInside(b, a) &&
+	        glyph_tess_middleInside(a, b) &&
+	        ((glyph_tess_area(a->prev, a, b->prev) != 0.0) ||
+	         (glyph_tess_area(a, b->prev, b) != 0.0))) ||
+	       (glyph_tess_equals(a, b) &&
+	        (glyph_tess_area(a->prev, a, a->next) > 0.0) &&
+	        (glyph_tess_area(b->prev, b, b->next) > 0.0));
+}
+
+// link a to b with a bridge which splits a ring into two
+// rings or merges a hole into a ring
+static glyph_tessNode_t*
+glyph_tess_splitPolygon(glyph_tess_t* self,
+                        glyph_tessNode_t* a,
+                        glyph_tessNode_t* b)
+{
+	ASSERT(self);
+
+	glyph_tessNode_t* a2 = glyph_tess_node(self, a->i);
+	glyph_tessNode_t* b2 = glyph_tess_node(self, b->i);
+	glyph_tessNode_t* an = a->next;
+	glyph_tessNode_t* bp = b->prev;
+
+	a->next  = b;
+	b->prev  = a;
+	a2->next = an;
+	an->prev = a2;
+	b2->next = a2;
+	a2->prev = b2;
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+// remove duplicate and collinear points
+static glyph_tessNode_t*
+glyph_tess_filterPoints(glyph_tessNode_t* start,
+                        glyph_tessNode_t* end)
+{
+	if(start == NULL)
+	{
+		return NULL;
+	}
+
+	if(end == NULL)
+	{
+		end = start;
+	}
+
+	glyph_tessNode_t* p = start;
+	int               again;
+	do
+	{
+		again = 0;
+		if((p->steiner == 0) &&
+		   (glyph_tess_equals(p, p->next) ||
+		    (glyph_tess_area(p->prev, p, p->next) == 0.0)))
+		{
+			glyph_tess_removeNode(p);
+			p = end = p->prev;
+			if(p == p->next)
+			{
+				break;
+			}
+			again = 1;
+		}
+		else
+		{
+			p = p->next;
+		}
+	} while(again || (p != end));
+
+	return end;
+}
+
+static void
+glyph_tess_triangle(glyph_tess_t* self, glyph_tessNode_t* a,
+                    glyph_tessNode_t* b, glyph_tessNode_t* c)
+{
+	ASSERT(self);
+	ASSERT(self->ni + 3 <= self->max_indices);
+
+	uint16_t* indices = &self->indices[self->ni];
+	indices[0] = (uint16_t) a->i;
+	indices[1] = (uint16_t) b->i;
+	indices[2] = (uint16_t) c->i;
+	self->ni += 3;
+}
+
+// interleave the bits of the coordinates scaled to 15 bits
+static uint32_t
+glyph_tess_zOrder(glyph_tessZ_t* zb, double x, double y)
+{
+	ASSERT(zb);
+
+	uint32_t zx = (uint32_t) ((x - zb->min_x)*zb->inv_size);
+	uint32_t zy = (uint32_t) ((y - zb->min_y)*zb->inv_size);
+
+	zx = (zx | (zx << 8)) & 0x00FF00FF;
+	zx = (zx | (zx << 4)) & 0x0F0F0F0F;
+	zx = (zx | (zx << 2)) & 0x33333333;
+	zx = (zx | (zx << 1)) & 0x55555555;
+
+	zy = (zy | (zy << 8)) & 0x00FF00FF;
+	zy = (zy | (zy << 4)) & 0x0F0F0F0F;
+	zy = (zy | (zy << 2)) & 0x33333333;
+	zy = (zy | (zy << 1)) & 0x55555555;
+
+	return zx | (zy << 1);
+}
+
+// sort the z-order list with a linked list merge sort
+static void glyph_tess_sortLinked(glyph_tessNode_t* list)
+{
+	int in_size = 1;
+	int merges;
+	do
+	{
+		glyph_tessNode_t* p    = list;
+		glyph_tessNode_t* tail = NULL;
+		list   = NULL;
+		merges = 0;
+
+		while(p)
+		{
+			++merges;
+
+			int               i;
+			int               p_size = 0;
+			glyph_tessNode_t* q      = p;
+			for(i = 0; i < in_size; ++i)
+			{
+				++p_size;
+				q = q->nextZ;
+				if(q == NULL)
+				{
+					break;
+				}
+			}
+
+			int q_size = in_size;
+			while((p_size > 0) || ((q_size > 0) && q))
+			{
+				glyph_tessNode_t* e;
+				if((p_size != 0) &&
+				   ((q_size == 0) || (q == NULL) ||
+				    (p->z <= q->z)))
+				{
+					e = p;
+					p = p->nextZ;
+					--p_size;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					--q_size;
+				}
+
+				if(tail)
+				{
+					tail->nextZ = e;
+				}
+				else
+				{
+					list = e;
+				}
+
+				e->prevZ = tail;
+				tail     = e;
+			}
+
+			p = q;
+		}
+
+		tail->nextZ = NULL;
+		in_size *= 2;
+	} while(merges > 1);
+}
+
+static void
+glyph_tess_indexCurve(glyph_tessNode_t* start,
+                      glyph_tessZ_t* zb)
+{
+	ASSERT(start);
+	ASSERT(zb);
+
+	glyph_tessNode_t* p = start;
+	do
+	{
+		if(p->z == 0)
+		{
+			p->z = glyph_tess_zOrder(zb, p->x, p->y);
+		}
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	} while(p != start);
+
+	p->prevZ->nextZ = NULL;
+	p->prevZ        = NULL;
+
+	glyph_tess_sortLinked(p);
+}
+
+// the point is inside the ear (a, b, c) and is a reflex
+// vertex which prevents the ear from being clipped
+static int
+glyph_tess_blocks(glyph_tessNode_t* p,
+                  glyph_tessNode_t* a, glyph_tessNode_t* b,
+                  glyph_tessNode_t* c,
+                  double x0, double y0, double x1, double y1)
+{
+	return (p->x >= x0) && (p->x <= x1) &&
+	       (p->y >= y0) && (p->y <= y1) &&
+	       glyph_tess_pointInTriangle(a->x, a->y, b->x, b->y,
+	                                  c->x, c->y, p->x, p->y) &&
+	       (glyph_tess_area(p->prev, p, p->next) >= 0.0);
+}
+
+static int glyph_tess_isEar(glyph_tessNode_t* ear)
+{
+	ASSERT(ear);
+
+	glyph_tessNode_t* a = ear->prev;
+	glyph_tessNode_t* b = ear;
+	glyph_tessNode_t* c = ear->next;
+
+	// reflex vertices are not ears
+	if(glyph_tess_area(a, b, c) >= 0.0)
+	{
+		return 0;
+	}
+
+	double x0 = fmin(a->x, fmin(b->x, c->x));
+	double y0 = fmin(a->y, fmin(b->y, c->y));
+	double x1 = fmax(a->x, fmax(b->x, c->x));
+	double y1 = fmax(a->y, fmax(b->y, c->y));
+
+	glyph_tessNode_t* p = c->next;
+	while(p != a)
+	{
+		if(glyph_tess_blocks(p, a, b, c, x0, y0, x1, y1))
+		{
+			return 0;
+		}
+		p = p->next;
+	}
+
+	return 1;
+}
+
+static int
+glyph_tess_isEarHashed(glyph_tessNode_t* ear,
+                       glyph_tessZ_t* zb)
+{
+	ASSERT(ear);
+	ASSERT(zb);
+
+	glyph_tessNode_t* a = ear->prev;
+	glyph_tessNode_t* b = ear;
+	glyph_tessNode_t* c = ear->next;
+
+	if(glyph_tess_area(a, b, c) >= 0.0)
+	{
+		return 0;
+	}
+
+	double x0 = fmin(a->x, fmin(b->x, c->x));
+	double y0 = fmin(a->y, fmin(b->y, c->y));
+	double x1 = fmax(a->x, fmax(b->x, c->x));
+	double y1 = fmax(a->y, fmax(b->y, c->y));
+
+	// only the points in the z-order range of the bounding
+	// box of the ear may be inside the ear
+	uint32_t min_z = glyph_tess_zOrder(zb, x0, y0);
+	uint32_t max_z = glyph_tess_zOrder(zb, x1, y1);
+
+	glyph_tessNode_t* p = ear->prevZ;
+	glyph_tessNode_t* n = ear->nextZ;
+	while(p && (p->z >= min_z) && n && (n->z <= max_z))
+	{
+		if((p != a) && (p != c) &&
+		   glyph_tess_blocks(p, a, b, c, x0, y0, x1, y1))
+		{
+			return 0;
+		}
+		p = p->prevZ;
+
+		if((n != a) && (n != c) &&
+		   glyph_tess_blocks(n, a, b, c, x0, y0, x1, y1))
+		{
+			return 0;
+		}
+		n = n->nextZ;
+	}
+
+	while(p && (p->z >= min_z))
+	{
+		if((p != a) && (p != c) &&
+		   glyph_tess_blocks(p, a, b, c, x0, y0, x1, y1))
+		{
+			return 0;
+		}
+		p = p->prevZ;
+	}
+
+	while(n && (n->z <= max_z))
+	{
+		if((n != a) && (n != c) &&
+		   glyph_tess_blocks(n, a, b, c, x0, y0, x1, y1))
+		{
+			return 0;
+		}
+		n = n->nextZ;
+	}
+
+	return 1;
+}
+
+// clip the small local self intersections which are
+// introduced by filtering
+static glyph_tessNode_t*
+glyph_tess_cureLocalIntersections(glyph_tess_t* self,
+                                  glyph_tessNode_t* start)
+{
+	ASSERT(self);
+	ASSERT(start);
+
+	glyph_tessNode_t* p = start;
+	do
+	{
+		glyph_tessNode_t* a = p->prev;
+		glyph_tessNode_t* b = p->next->next;
+
+		if((glyph_tess_equals(a, b) == 0) &&
+		   glyph_tess_intersects(a, p, p->next, b) &&
+		   glyph_tess_locallyInside(a, b) &&
+		   glyph_tess_locallyInside(b, a))
+		{
+			glyph_tess_triangle(self, a, p, b);
+
+			glyph_tess_removeNode(p);
+			glyph_tess_removeNode(p->next);
+
+			p = start = b;
+		}
+		p = p->next;
+	} while(p != start);
+
+	return glyph_tess_filterPoints(p, NULL);
+}
+
+static void
+glyph_tess_earcut(glyph_tess_t* self, glyph_tessNode_t* ear,
+                  glyph_tessZ_t* zb, int pass);
+
+// split the ring by a valid diagonal and triangulate the
+// halves independently
+static void
+glyph_tess_splitEarcut(glyph_tess_t* self,
+                       glyph_tessNode_t* start,
+                       glyph_tessZ_t* zb)
+{
+	ASSERT(self);
+	ASSERT(start);
+
+	glyph_tessNode_t* a = start;
+	do
+	{
+		glyph_tessNode_t* b = a->next->next;
+		while(b != a->prev)
+		{
+			if((a->i != b->i) &&
+			   glyph_tess_isValidDiagonal(a, b))
+			{
+				glyph_tessNode_t* c;
+				c = glyph_tess_splitPolygon(self, a, b);
+
+				a = glyph_tess_filterPoints(a, a->next);
+				c = glyph_tess_filterPoints(c, c->next);
+
+				glyph_tess_earcut(self, a, zb, 0);
+				glyph_tess_earcut(self, c, zb, 0);
+				return;
+			}
+			b = b->next;
+		}
+		a = a->next;
+	} while(a != start);
+}
+
+// clip ears until the ring is a single triangle where the
+// passes recover from degenerate rings by filtering the
+// points, curing local intersections and splitting the ring
+static void
+glyph_tess_earcut(glyph_tess_t* self, glyph_tessNode_t* ear,
+                  glyph_tessZ_t* zb, int pass)
+{
+	ASSERT(self);
+
+	if(ear == NULL)
+	{
+		return;
+	}
+
+	if((pass == 0) && zb)
+	{
+		glyph_tess_indexCurve(ear, zb);
+	}
+
+	glyph_tessNode_t* stop = ear;
+	while(ear->prev != ear->next)
+	{
+		glyph_tessNode_t* prev = ear->prev;
+		glyph_tessNode_t* next = ear->next;
+
+		int is_ear = zb ? glyph_tess_isEarHashed(ear, zb) :
+		                  glyph_tess_isEar(ear);
+		if(is_ear)
+		{
+			glyph_tess_triangle(self, prev, ear, next);
+			glyph_tess_removeNode(ear);
+
+			// skipping the next vertex reduces slivers
+			ear  = next->next;
+			stop = next->next;
+			continue;
+		}
+
+		ear = next;
+		if(ear == stop)
+		{
+			if(pass == 0)
+			{
+				ear = glyph_tess_filterPoints(ear, NULL);
+				glyph_tess_earcut(self, ear, zb, 1);
+			}
+			else if(pass == 1)
+			{
+				ear = glyph_tess_filterPoints(ear, NULL);
+				ear = glyph_tess_cureLocalIntersections(self, ear);
+				glyph_tess_earcut(self, ear, zb, 2);
+			}
+			else if(pass == 2)
+			{
+				glyph_tess_splitEarcut(self, ear, zb);
+			}
+			break;
+		}
+	}
+}
+
+// build the ring of a contour in the winding order of
+// outer contours (clockwise) or holes
+static glyph_tessNode_t*
+glyph_tess_linkedList(glyph_tess_t* self, int c, int clockwise)
+{
+	ASSERT(self);
+
+	int start = self->contours[c];
+	int end   = (c + 1 < self->nc) ? self->contours[c + 1] :
+	                                 self->np;
+
+	int               i;
+	glyph_tessNode_t* last = NULL;
+	if(clockwise == (self->info[c].area > 0.0))
+	{
+		for(i = start; i < end; ++i)
+		{
+			last = glyph_tess_insertNode(self, i, last);
+		}
+	}
+	else
+	{
+		for(i = end - 1; i >= start; --i)
+		{
+			last = glyph_tess_insertNode(self, i, last);
+		}
+	}
+
+	if(last && glyph_tess_equals(last, last->next))
+	{
+		glyph_tess_removeNode(last);
+		last = last->next;
+	}
+
+	return last;
+}
+
+// find the bridge from the leftmost point of a hole to the
+// ring with the algorithm of David Eberly
+static glyph_tessNode_t*
+glyph_tess_findHoleBridge(glyph_tessNode_t* hole,
+                          glyph_tessNode_t* outer)
+{
+	ASSERT(hole);
+	ASSERT(outer);
+
+	// find the segment which is intersected by a ray from the
+	// hole to the left where the endpoint with the smaller x
+	// is a candidate for the bridge
+	glyph_tessNode_t* p  = outer;
+	glyph_tessNode_t* m  = NULL;
+	double            hx = hole->x;
+	double            hy = hole->y;
+	double            qx = -DBL_MAX;
+	do
+	{
+		if((hy <= p->y) && (hy >= p->next->y) &&
+		   (p->next->y != p->y))
+		{
+			double x = p->x + (hy - p->y)*(p->next->x - p->x)/
+			                  (p->next->y - p->y);
+			if((x <= hx) && (x > qx))
+			{
+				qx = x;
+				m  = (p->x < p->next->x) ? p : p->next;
+				if(x == hx)
+				{
+					// the hole touches the segment
+					return m;
+				}
+			}
+		}
+		p = p->next;
+	} while(p != outer);
+
+	if(m == NULL)
+	{
+		return NULL;
+	}
+
+	// the bridge is valid when no points are inside the
+	// triangle of the hole point, the intersection and the
+	// candidate otherwise select the point inside the
+	// triangle with the minimum angle to the ray
+	glyph_tessNode_t* stop    = m;
+	double            mx      = m->x;
+	double            my      = m->y;
+	double            tan_min = DBL_MAX;
+	p = m;
+	do
+	{
+		if((hx >= p->x) && (p->x >= mx) && (hx != p->x) &&
+		   glyph_tess_pointInTriangle((hy < my) ? hx : qx, hy,
+		                              mx, my,
+		                              (hy < my) ? qx : hx, hy,
+		                              p->x, p->y))
+		{
+			double tan = fabs(hy - p->y)/(hx - p->x);
+			if(glyph_tess_locallyInside(p, hole) &&
+			   ((tan < tan_min) ||
+			    ((tan == tan_min) &&
+			     ((p->x > m->x) ||
+			      ((p->x == m->x) &&
+			       (glyph_tess_area(m->prev, m, p->prev) < 0.0) &&
+			       (glyph_tess_area(p->next, m, m->next) < 0.0))))))
+			{
+				m       = p;
+				tan_min = tan;
+			}
+		}
+		p = p->next;
+	} while(p != stop);
+
+	return m;
+}
+
+static glyph_tessNode_t*
+glyph_tess_leftmost(glyph_tessNode_t* start)
+{
+	ASSERT(start);
+
+	glyph_tessNode_t* p        = start;
+	glyph_tessNode_t* leftmost = start;
+	do
+	{
+		if((p->x < leftmost->x) ||
+		   ((p->x == leftmost->x) && (p->y < leftmost->y)))
+		{
+			leftmost = p;
+		}
+		p = p->next;
+	} while(p != start);
+
+	return leftmost;
+}
+
+static int glyph_tess_compareX(const void* a, const void* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	const glyph_tessNode_t* na = *((glyph_tessNode_t**) a);
+	const glyph_tessNode_t* nb = *((glyph_tessNode_t**) b);
+
+	if(na->x < nb->x)
+	{
+		return -1;
+	}
+	else if(na->x > nb->x)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+// classify the contours by their nesting depth
+static void glyph_tess_classify(glyph_tess_t* self)
+{
+	ASSERT(self);
+
+	int c;
+	int i;
+	for(c = 0; c < self->nc; ++c)
+	{
+		glyph_tessContour_t* info = &self->info[c];
+
+		int start = self->contours[c];
+		int end   = (c + 1 < self->nc) ? self->contours[c + 1] :
+		                                 self->np;
+
+		// signed area (see glyph_tess_linkedList) and bounds
+		info->area  = 0.0;
+		info->min_x = DBL_MAX;
+		info->min_y = DBL_MAX;
+		info->max_x = -DBL_MAX;
+		info->max_y = -DBL_MAX;
+		info->depth  = 0;
+		info->parent = -1;
+
+		int j = end - 1;
+		for(i = start; i < end; ++i)
+		{
+			double xi = (double) self->xy[2*i];
+			double yi = (double) self->xy[2*i + 1];
+			double xj = (double) self->xy[2*j];
+			double yj = (double) self->xy[2*j + 1];
+
+			info->area += (xj - xi)*(yi + yj);
+			info->min_x = fmin(info->min_x, xi);
+			info->min_y = fmin(info->min_y, yi);
+			info->max_x = fmax(info->max_x, xi);
+			info->max_y = fmax(info->max_y, yi);
+			j = i;
+		}
+	}
+
+	// count the contours which contain the first point of
+	// each contour where the parent is the smallest container
+	for(c = 0; c < self->nc; ++c)
+	{
+		glyph_tessContour_t* info = &self->info[c];
+
+		int    start = self->contours[c];
+		double px    = (double) self->xy[2*start];
+		double py    = (double) self->xy[2*start + 1];
+
+		int k;
+		for(k = 0; k < self->nc; ++k)
+		{
+			glyph_tessContour_t* other = &self->info[k];
+			if((k == c) ||
+			   (px < other->min_x) || (px > other->max_x) ||
+			   (py < other->min_y) || (py > other->max_y))
+			{
+				continue;
+			}
+
+			int ks = self->contours[k];
+			int ke = (k + 1 < self->nc) ? self->contours[k + 1] :
+			                              self->np;
+			int in = 0;
+			int j  = ke - 1;
+			for(i = ks; i < ke; ++i)
+			{
+				double xi = (double) self->xy[2*i];
+				double yi = (double) self->xy[2*i + 1];
+				double xj = (double) self->xy[2*j];
+				double yj = (double) self->xy[2*j + 1];
+				if(((yi > py) != (yj > py)) &&
+				   (px < (xj - xi)*(py - yi)/(yj - yi) + xi))
+				{
+					in = !in;
+				}
+				j = i;
+			}
+
+			if(in)
+			{
+				++info->depth;
+				if((info->parent < 0) ||
+				   (fabs(other->area) <
+				    fabs(self->info[info->parent].area)))
+				{
+					info->parent = k;
+				}
+			}
+		}
+	}
+}
+
+static int
+glyph_tess_reserve(glyph_tess_t* self)
+{
+	ASSERT(self);
+
+	// the bridges and splits add two nodes each and each
+	// triangle removes at least one node
+	int max_nodes = 3*self->np + 6*self->nc + 8;
+	if(max_nodes > self->max_nodes)
+	{
+		glyph_tessNode_t* nodes;
+		nodes = (glyph_tessNode_t*)
+		        REALLOC(self->nodes,
+		                max_nodes*sizeof(glyph_tessNode_t));
+		if(nodes == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->nodes     = nodes;
+		self->max_nodes = max_nodes;
+
+		uint16_t* indices;
+		indices = (uint16_t*)
+		          REALLOC(self->indices,
+		                  3*max_nodes*sizeof(uint16_t));
+		if(indices == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->indices     = indices;
+		self->max_indices = 3*max_nodes;
+	}
+
+	if(self->nc > self->max_contours)
+	{
+		int max_contours = self->max_contours ?
+		                   2*self->max_contours : 16;
+		while(max_contours < self->nc)
+		{
+			max_contours *= 2;
+		}
+
+		glyph_tessNode_t** queue;
+		queue = (glyph_tessNode_t**)
+		        REALLOC(self->queue,
+		                max_contours*sizeof(glyph_tessNode_t*));
+		if(queue == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->queue = queue;
+
+		glyph_tessContour_t* info;
+		info = (glyph_tessContour_t*)
+		       REALLOC(self->info,
+		               max_contours*sizeof(glyph_tessContour_t));
+		if(info == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->info = info;
+
+		self->max_contours = max_contours;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_tess_t* glyph_tess_new(void)
+{
+	glyph_tess_t* self;
+	self = (glyph_tess_t*)
+	       CALLOC(1, sizeof(glyph_tess_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	return self;
+}
+
+void glyph_tess_delete(glyph_tess_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_tess_t* self = *_self;
+	if(self)
+	{
+		FREE(self->indices);
+		FREE(self->info);
+		FREE(self->queue);
+		FREE(self->nodes);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int glyph_tess_triangulate(glyph_tess_t* self,
+                           glyph_sink_t* sink)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(sink->point_fn == NULL);
+
+	self->np          = sink->np;
+	self->xy          = sink->xy;
+	self->nc          = sink->nc;
+	self->contours    = sink->contours;
+	self->ni          = 0;
+	self->count_nodes = 0;
+
+	// indices are 16-bit
+	if(self->np > GLYPH_ARENA_MAX_MESH_VERTICES)
+	{
+		LOGE("invalid np=%i", self->np);
+		return 0;
+	}
+
+	if(glyph_tess_reserve(self) == 0)
+	{
+		return 0;
+	}
+
+	glyph_tess_classify(self);
+
+	// triangulate each outer contour with its holes
+	int c;
+	int h;
+	for(c = 0; c < self->nc; ++c)
+	{
+		glyph_tessContour_t* info = &self->info[c];
+		if(info->depth%2)
+		{
+			continue;
+		}
+
+		int               points = 0;
+		glyph_tessNode_t* outer;
+		outer = glyph_tess_linkedList(self, c, 1);
+		if((outer == NULL) || (outer->next == outer->prev))
+		{
+			continue;
+		}
+
+		int count = 0;
+		for(h = 0; h < self->nc; ++h)
+		{
+			if(self->info[h].parent != c)
+			{
+				continue;
+			}
+
+			glyph_tessNode_t* hole;
+			hole = glyph_tess_linkedList(self, h, 0);
+			if(hole == NULL)
+			{
+				continue;
+			}
+
+			if(hole == hole->next)
+			{
+				hole->steiner = 1;
+			}
+
+			self->queue[count++] = glyph_tess_leftmost(hole);
+		}
+
+		// bridge the holes from left to right
+		qsort((void*) self->queue, count,
+		      sizeof(glyph_tessNode_t*), glyph_tess_compareX);
+		for(h = 0; h < count; ++h)
+		{
+			glyph_tessNode_t* bridge;
+			bridge = glyph_tess_findHoleBridge(self->queue[h],
+			                                   outer);
+			if(bridge == NULL)
+			{
+				continue;
+			}
+
+			glyph_tessNode_t* reverse;
+			reverse = glyph_tess_splitPolygon(self, bridge,
+			                                  self->queue[h]);
+			glyph_tess_filterPoints(reverse, reverse->next);
+			outer = glyph_tess_filterPoints(bridge, bridge->next);
+		}
+
+		// hash the ear tests of larger rings
+		glyph_tessNode_t* p = outer;
+		glyph_tessZ_t     zb;
+		double            max_x = p->x;
+		double            max_y = p->y;
+		zb.min_x = p->x;
+		zb.min_y = p->y;
+		do
+		{
+			zb.min_x = fmin(zb.min_x, p->x);
+			zb.min_y = fmin(zb.min_y, p->y);
+			max_x    = fmax(max_x, p->x);
+			max_y    = fmax(max_y, p->y);
+			++points;
+			p = p->next;
+		} while(p != outer);
+
+		double size = fmax(max_x - zb.min_x, max_y - zb.min_y);
+		zb.inv_size = (size > 0.0) ? 32767.0/size : 0.0;
+
+		if((points > GLYPH_TESS_ZORDER_POINTS) &&
+		   (zb.inv_size > 0.0))
+		{
+			glyph_tess_earcut(self, outer, &zb, 0);
+		}
+		else
+		{
+			glyph_tess_earcut(self, outer, NULL, 0);
+		}
+	}
+
+	return 1;
+}
+
+int glyph_tess_build(glyph_tess_t* self,
+                     glyph_sink_t* sink,
+                     glyph_arena_t* arena,
+                     glyph_arenaMesh_t* mesh)
+{
+	ASSERT(self);
+	ASSERT(sink);
+	ASSERT(arena);
+	ASSERT(mesh);
+
+	if(glyph_tess_triangulate(self, sink) == 0)
+	{
+		return 0;
+	}
+
+	if(glyph_arena_alloc(arena, mesh, self->np, self->ni) == 0)
+	{
+		return 0;
+	}
+
+	memcpy((void*) glyph_arena_vertices(arena, mesh),
+	       (const void*) self->xy,
+	       2*self->np*sizeof(float));
+	memcpy((void*) glyph_arena_indices(arena, mesh),
+	       (const void*) self->indices,
+	       self->ni*sizeof(uint16_t));
+
+	return 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_tess_H
+#define glyph_tess_H
+
+#include <stdint.h>
+
+#include "glyph_arena.h"
+#include "glyph_sink.h"
+
+// The glyph tessellator is an alternative to the libtess2
+// tessellator of vkk_vgPolygonBuilder which is specialized
+// for glyph outlines. The contours of a glyph are closed and
+// do not intersect so each contour is classified as an outer
+// contour or a hole by its nesting depth (even-odd). Each
+// outer contour is triangulated by ear clipping after its
+// holes are bridged into it and the ear tests are
+// accelerated with a z-order curve for larger contours. The
+// nodes, contours and indices are stored in pools which are
+// retained across builds so a build does not allocate once
+// the pools are large enough.
+//
+// The points are read from the point buffer of a sink (see
+// glyph_sink.h) and the mesh is built into the mesh arena.
+// The vertices of the mesh are the points and the triangle
+// indices are relative to the first vertex.
+
+typedef struct glyph_tess_s
+{
+	// points (x,y) and contour starts of the sink which
+	// is being triangulated
+	int          np;
+	const float* xy;
+	int          nc;
+	const int*   contours;
+
+	// pools retained across builds
+	int                          count_nodes;
+	int                          max_nodes;
+	struct glyph_tessNode_s*     nodes;
+	int                          max_contours;
+	struct glyph_tessNode_s**    queue;
+	struct glyph_tessContour_s*  info;
+	int                          ni;
+	int                          max_indices;
+	uint16_t*                    indices;
+} glyph_tess_t;
+
+glyph_tess_t* glyph_tess_new(void);
+void          glyph_tess_delete(glyph_tess_t** _self);
+int           glyph_tess_triangulate(glyph_tess_t* self,
+                                     glyph_sink_t* sink);
+int           glyph_tess_build(glyph_tess_t* self,
+                               glyph_sink_t* sink,
+                               glyph_arena_t* arena,
+                               glyph_arenaMesh_t* mesh);
+
+#endif
@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "glyph"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "glyph_text.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define GLYPH_TEXT_REPLACEMENT 0xFFFD
+
+static uint32_t glyph_text_decode(const char** _str)
+{
+	ASSERT(_str);
+
+	const uint8_t* s = (const uint8_t*) *_str;
+
+	// decode the lead byte
+	int      n;
+	uint32_t code;
+	if(s[0] < 0x80)
+	{
+		n    = 0;
+		code = s[0];
+	}
+	else if((s[0] & 0xE0) == 0xC0)
+	{
+		n    = 1;
+		code = s[0] & 0x1F;
+	}
+	else if((s[0] & 0xF0) == 0xE0)
+	{
+		n    = 2;
+		code = s[0] & 0x0F;
+	}
+	else if((s[0] & 0xF8) == 0xF0)
+	{
+		n    = 3;
+		code = s[0] & 0x07;
+	}
+	else
+	{
+		*_str += 1;
+		return GLYPH_TEXT_REPLACEMENT;
+	}
+
+	// decode the continuation bytes where a truncated
+	// sequence stops before the '\0' or the next lead byte
+	int i;
+	for(i = 1; i <= n; ++i)
+	{
+		if((s[i] & 0xC0) != 0x80)
+		{
+			*_str += i;
+			return GLYPH_TEXT_REPLACEMENT;
+		}
+
+		code = (code << 6) | (s[i] & 0x3F);
+	}
+
+	*_str += n + 1;
+	return code;
+}
+
+static int
+glyph_text_append(glyph_text_t* self, glyph_object_t* glyph,
+                  float x, float y, float scale, int style)
+{
+	ASSERT(self);
+	ASSERT(glyph);
+
+	if(self->count >= self->max_glyphs)
+	{
+		int max_glyphs = self->max_glyphs ?
+		                 2*self->max_glyphs : 64;
+
+		glyph_textGlyph_t* glyphs;
+		glyphs = (glyph_textGlyph_t*)
+		         REALLOC(self->glyphs,
+		                 max_glyphs*sizeof(glyph_textGlyph_t));
+		if(glyphs == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->glyphs = glyphs;
+
+		// a polygon contains at most every glyph
+		float* bounds;
+		bounds = (float*)
+		         REALLOC(self->bounds,
+		                 4*max_glyphs*sizeof(float));
+		if(bounds == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+		self->bounds = bounds;
+
+		self->max_glyphs = max_glyphs;
+	}
+
+	glyph_textGlyph_t* g = &self->glyphs[self->count];
+	g->glyph = glyph;
+	g->x     = x;
+	g->y     = y;
+	g->scale = scale;
+	g->style = style;
+	++self->count;
+
+	self->dirty = 1;
+
+	return 1;
+}
+
+static void
+glyph_text_release(glyph_text_t* self, int first)
+{
+	ASSERT(self);
+
+	// release the polygons starting at first
+	int i;
+	for(i = first; i < self->poly_count; ++i)
+	{
+		vkk_vgPolygon_delete(&self->polys[i].poly);
+	}
+	self->poly_count = first;
+}
+
+static int
+glyph_text_overlap(glyph_text_t* self, const float* b)
+{
+	ASSERT(self);
+	ASSERT(b);
+
+	int i;
+	for(i = 0; i < self->bound_count; ++i)
+	{
+		const float* a = &self->bounds[4*i];
+		if((b[0] < a[2]) && (a[0] < b[2]) &&
+		   (b[1] < a[3]) && (a[1] < b[3]))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+glyph_text_flush(glyph_text_t* self,
+                 vkk_vgPolygonBuilder_t* pb,
+                 int style, int* _points)
+{
+	ASSERT(self);
+	ASSERT(pb);
+	ASSERT(_points);
+
+	// build the polygon of the placed glyphs
+	int points = *_points;
+	*_points          = 0;
+	self->bound_count = 0;
+	if(points < 3)
+	{
+		vkk_vgPolygonBuilder_reset(pb);
+		return 1;
+	}
+
+	if(self->poly_count >= self->max_polys)
+	{
+		int max_polys = self->max_polys ?
+		                2*self->max_polys : 8;
+
+		glyph_textPolygon_t* polys;
+		polys = (glyph_textPolygon_t*)
+		        REALLOC(self->polys,
+		                max_polys*sizeof(glyph_textPolygon_t));
+		if(polys == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+
+		self->polys     = polys;
+		self->max_polys = max_polys;
+	}
+
+	double t0 = cc_timestamp();
+
+	vkk_vgPolygon_t* poly = vkk_vgPolygonBuilder_build(pb);
+	vkk_vgPolygonBuilder_reset(pb);
+	if(poly == NULL)
+	{
+		return 0;
+	}
+
+	glyph_textPolygon_t* p = &self->polys[self->poly_count];
+	p->style = style;
+	p->poly  = poly;
+	++self->poly_count;
+
+	self->stats.builds    += 1;
+	self->stats.tess_time += cc_timestamp() - t0;
+
+	return 1;
+}
+
+static int
+glyph_text_place(glyph_text_t* self,
+                 vkk_vgPolygonBuilder_t* pb,
+                 glyph_textGlyph_t* g, int* _points,
+                 int steps, int thresh, int flags)
+{
+	ASSERT(self);
+	ASSERT(pb);
+	ASSERT(g);
+	ASSERT(_points);
+
+	glyph_sink_t* sink = self->sink;
+	glyph_sink_reset(sink);
+	glyph_sink_place(sink, g->x, g->y, g->scale);
+	if(glyph_object_emit(g->glyph, sink, steps, thresh,
+	                     flags, &self->stats) == 0)
+	{
+		return 0;
+	}
+
+	if(sink->np == 0)
+	{
+		return 1;
+	}
+
+	// bounds of the placed points
+	int    i;
+	float* b = &self->bounds[4*self->bound_count];
+	b[0] = sink->xy[0];
+	b[1] = sink->xy[1];
+	b[2] = b[0];
+	b[3] = b[1];
+	for(i = 1; i < sink->np; ++i)
+	{
+		float x = sink->xy[2*i];
+		float y = sink->xy[2*i + 1];
+		b[0] = (x < b[0]) ? x : b[0];
+		b[1] = (y < b[1]) ? y : b[1];
+		b[2] = (x > b[2]) ? x : b[2];
+		b[3] = (y > b[3]) ? y : b[3];
+	}
+
+	// start a new polygon when the glyph does not fit
+	if((*_points + sink->np > GLYPH_TEXT_MAX_POINTS) ||
+	   glyph_text_overlap(self, b))
+	{
+		float tmp[4] = { b[0], b[1], b[2], b[3] };
+		if(glyph_text_flush(self, pb, g->style, _points) == 0)
+		{
+			return 0;
+		}
+
+		b    = self->bounds;
+		b[0] = tmp[0];
+		b[1] = tmp[1];
+		b[2] = tmp[2];
+		b[3] = tmp[3];
+	}
+
+	if(glyph_polygon_append(pb, sink) == 0)
+	{
+		return 0;
+	}
+
+	*_points += sink->np;
+	++self->bound_count;
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+glyph_text_t* glyph_text_new(glyph_font_t* font)
+{
+	ASSERT(font);
+
+	glyph_text_t* self;
+	self = (glyph_text_t*)
+	       CALLOC(1, sizeof(glyph_text_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->sink = glyph_sink_new(NULL, NULL);
+	if(self->sink == NULL)
+	{
+		goto fail_sink;
+	}
+
+	self->font  = font;
+	self->dirty = 1;
+
+	// success
+	return self;
+
+	// failure
+	fail_sink:
+		FREE(self);
+	return NULL;
+}
+
+void glyph_text_delete(glyph_text_t** _self)
+{
+	ASSERT(_self);
+
+	glyph_text_t* self = *_self;
+	if(self)
+	{
+		glyph_text_release(self, 0);
+		glyph_sink_delete(&self->sink);
+		FREE(self->bounds);
+		FREE(self->polys);
+		FREE(self->glyphs);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void glyph_text_clear(glyph_text_t* self)
+{
+	ASSERT(self);
+
+	glyph_text_release(self, 0);
+
+	self->count       = 0;
+	self->style_count = 0;
+	self->dirty       = 1;
+}
+
+int glyph_text_style(glyph_text_t* self,
+                     vkk_vgPolygonStyle_t* style)
+{
+	ASSERT(self);
+	ASSERT(style);
+
+	// reuse the group of an identical style
+	int i;
+	for(i = 0; i < self->style_count; ++i)
+	{
+		if(memcmp((const void*) &self->styles[i],
+		          (const void*) style,
+		          sizeof(vkk_vgPolygonStyle_t)) == 0)
+		{
+			return i;
+		}
+	}
+
+	if(self->style_count >= GLYPH_TEXT_MAX_STYLES)
+	{
+		LOGE("invalid style_count=%i", self->style_count);
+		return -1;
+	}
+
+	self->styles[i] = *style;
+	++self->style_count;
+
+	return i;
+}
+
+int glyph_text_add(glyph_text_t* self, const char* str,
+                   float x, float y, float scale,
+                   int style)
+{
+	ASSERT(self);
+	ASSERT(str);
+
+	if((style < 0) || (style >= self->style_count))
+	{
+		LOGE("invalid style=%i", style);
+		return 0;
+	}
+
+	// the line height is the tallest glyph on the line or
+	// the height of the space for an empty line
+	float pen_x  = x;
+	float pen_y  = y;
+	float line_h = 0.0f;
+	while(*str)
+	{
+		uint32_t code = glyph_text_decode(&str);
+		if(code == '\n')
+		{
+			if(line_h == 0.0f)
+			{
+				glyph_object_t* space;
+				space = glyph_font_lookup(self->font, ' ');
+				if(space)
+				{
+					line_h = scale*space->h;
+				}
+			}
+
+			pen_x  = x;
+			pen_y += line_h;
+			line_h = 0.0f;
+			continue;
+		}
+
+		glyph_object_t* glyph;
+		glyph = glyph_font_lookup(self->font, code);
+		if(glyph == NULL)
+		{
+			continue;
+		}
+
+		// glyphs without an outline only advance the pen
+		// e.g. space character
+		if((glyph->np >= 3) &&
+		   (glyph_text_append(self, glyph, pen_x, pen_y,
+		                      scale, style) == 0))
+		{
+			return 0;
+		}
+
+		pen_x += scale*glyph->w;
+		if(scale*glyph->h > line_h)
+		{
+			line_h = scale*glyph->h;
+		}
+	}
+
+	return 1;
+}
+
+int glyph_text_build(glyph_text_t* self,
+                     vkk_vgPolygonBuilder_t* pb,
+                     int steps, int thresh, int flags,
+                     glyph_stats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(pb);
+
+	if((self->dirty  == 0)      &&
+	   (self->steps  == steps)  &&
+	   (self->thresh == thresh) &&
+	   (self->flags  == flags))
+	{
+		return self->failed ? 0 : 1;
+	}
+
+	// the parameters are latched so that a failed build is
+	// not retried every frame
+	self->dirty  = 0;
+	self->failed = 0;
+	self->steps  = steps;
+	self->thresh = thresh;
+	self->flags  = flags;
+
+	glyph_stats_reset(&self->stats);
+
+	// the new polygons are added after the previous polygons
+	// which are released once the build succeeds
+	int prev = self->poly_count;
+
+	// emit the glyphs of each style into shared polygons
+	int i;
+	int s;
+	for(s = 0; s < self->style_count; ++s)
+	{
+		int points = 0;
+		vkk_vgPolygonBuilder_reset(pb);
+		self->bound_count = 0;
+		for(i = 0; i < self->count; ++i)
+		{
+			glyph_textGlyph_t* g = &self->glyphs[i];
+			if(g->style != s)
+			{
+				continue;
+			}
+
+			if(glyph_text_place(self, pb, g, &points,
+			                    steps, thresh, flags) == 0)
+			{
+				goto fail_place;
+			}
+		}
+
+		if(glyph_text_flush(self, pb, s, &points) == 0)
+		{
+			goto fail_flush;
+		}
+	}
+
+	// replace the previous polygons
+	for(i = 0; i < prev; ++i)
+	{
+		vkk_vgPolygon_delete(&self->polys[i].poly);
+	}
+	memmove(self->polys, &self->polys[prev],
+	        (self->poly_count - prev)*sizeof(glyph_textPolygon_t));
+	self->poly_count -= prev;
+
+	if(stats)
+	{
+		glyph_stats_add(stats, &self->stats);
+	}
+
+	// success
+	return 1;
+
+	// failure
+	fail_flush:
+	fail_place:
+		LOGE("build failed steps=%i, thresh=%i, flags=%i",
+		     steps, thresh, flags);
+		vkk_vgPolygonBuilder_reset(pb);
+		glyph_text_release(self, prev);
+		self->failed = 1;
+	return 0;
+}
+
+int glyph_text_draw(glyph_text_t* self,
+                    vkk_vgContext_t* ctx)
+{
+	ASSERT(self);
+	ASSERT(ctx);
+
+	// the polygons must be bound by the caller
+	int i;
+	for(i = 0; i < self->poly_count; ++i)
+	{
+		glyph_textPolygon_t* p = &self->polys[i];
+		vkk_vgPolygon_draw(p->poly, ctx,
+		                   &self->styles[p->style]);
+	}
+
+	return self->poly_count;
+}
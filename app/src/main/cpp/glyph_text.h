@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef glyph_text_H
+#define glyph_text_H
+
+#include "libvkk/vkk_vg.h"
+#include "glyph_font.h"
+#include "glyph_object.h"
+#include "glyph_polygon.h"
+#include "glyph_sink.h"
+#include "glyph_stats.h"
+
+// A text run places the glyphs of UTF-8 strings along a pen
+// which advances by the glyph width w (scaled) and moves to
+// the next line on '\n'. The origin (x,y) is the top-left
+// corner of the first glyph box and the run is drawn with
+// the same y-down projection as a single glyph.
+//
+// vkk_vg draws a polygon with the transform of the context
+// so the run is recorded as polygons which contain the
+// translated and scaled points of the glyphs with a style.
+// A style is split into several polygons when a polygon
+// would exceed GLYPH_TEXT_MAX_POINTS (the meshes use 16-bit
+// indices and libtess2 may add vertices) or when the bounds
+// of a glyph overlap a glyph of the polygon since vkk_vg
+// fills with the odd winding rule which would cancel the
+// overlap. Drawing a run therefore requires a single bind and
+// one draw per polygon (typically one per style) regardless
+// of the number of glyphs. The polygons are rebuilt only when
+// the run or the build parameters change. A failed build
+// keeps the previous polygons and is not retried until the
+// run or the build parameters change. Glyphs which are
+// missing from the font are skipped.
+
+#define GLYPH_TEXT_MAX_STYLES 8
+#define GLYPH_TEXT_MAX_POINTS 32768
+
+typedef struct
+{
+	glyph_object_t* glyph;
+	float           x;
+	float           y;
+	float           scale;
+	int             style;
+} glyph_textGlyph_t;
+
+typedef struct
+{
+	int              style;
+	vkk_vgPolygon_t* poly;
+} glyph_textPolygon_t;
+
+typedef struct glyph_text_s
+{
+	glyph_font_t* font;
+
+	// placed glyphs
+	int                count;
+	int                max_glyphs;
+	glyph_textGlyph_t* glyphs;
+
+	// polygons are grouped by style
+	int                  style_count;
+	vkk_vgPolygonStyle_t styles[GLYPH_TEXT_MAX_STYLES];
+	int                  poly_count;
+	int                  max_polys;
+	glyph_textPolygon_t* polys;
+
+	// points of the glyph being placed and the bounds
+	// (x0,y0,x1,y1) of the glyphs of the polygon being built
+	glyph_sink_t* sink;
+	int           bound_count;
+	float*        bounds;
+
+	// parameters of the polygons which are rebuilt when
+	// dirty or when the parameters change
+	// failed latches a failed build of the parameters
+	int dirty;
+	int failed;
+	int steps;
+	int thresh;
+	int flags;
+
+	// statistics of the last build
+	glyph_stats_t stats;
+} glyph_text_t;
+
+glyph_text_t* glyph_text_new(glyph_font_t* font);
+void          glyph_text_delete(glyph_text_t** _self);
+void          glyph_text_clear(glyph_text_t* self);
+int           glyph_text_style(glyph_text_t* self,
+                               vkk_vgPolygonStyle_t* style);
+int           glyph_text_add(glyph_text_t* self,
+                             const char* str,
+                             float x, float y,
+                             float scale,
+                             int style);
+int           glyph_text_build(glyph_text_t* self,
+                               vkk_vgPolygonBuilder_t* pb,
+                               int steps,
+                               int thresh,
+                               int flags,
+                               glyph_stats_t* stats);
+int           glyph_text_draw(glyph_text_t* self,
+                              vkk_vgContext_t* ctx);
+
+#endif
@@ -1,4 +1,6 @@
 export RESOURCE=$PWD/app/src/main/assets/resource.bfs
+export PACK=$PWD/app/src/main/assets/BarlowSemiCondensed-Regular.gpk
+export GLYPH_PACK=$PWD/app/src/main/cpp/glyph-pack
 
 # clean resource
 rm $RESOURCE
@@ -9,6 +11,20 @@ bfs $RESOURCE blobSet readme.txt
 bfs $RESOURCE blobSet BarlowSemiCondensed-Regular.json
 cd ..
 
+echo GLYPH SHADERS
+cd resource
+glslangValidator -V glyph/shaders/mesh.vert -o glyph/shaders/mesh_vert.spv
+glslangValidator -V glyph/shaders/mesh.frag -o glyph/shaders/mesh_frag.spv
+bfs $RESOURCE blobSet glyph/shaders/mesh_vert.spv
+bfs $RESOURCE blobSet glyph/shaders/mesh_frag.spv
+cd ..
+
+echo GLYPH PACK
+$GLYPH_PACK resource/BarlowSemiCondensed-Regular.json $PACK
+cd app/src/main/assets
+bfs $RESOURCE blobSet BarlowSemiCondensed-Regular.gpk
+cd ../../../..
+
 echo VKK UI
 cd app/src/main/cpp/libvkk/ui/resource
 ./build-resource.sh $RESOURCE
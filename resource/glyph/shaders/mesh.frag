@@ -0,0 +1,13 @@
+#version 450
+
+layout(std140, set=0, binding=1) uniform uniformColor
+{
+	vec4 color;
+};
+
+layout(location=0) out vec4 fragColor;
+
+void main()
+{
+	fragColor = color;
+}
@@ -0,0 +1,13 @@
+#version 450
+
+layout(location=0) in vec2 xy;
+
+layout(std140, set=0, binding=0) uniform uniformMvp
+{
+	mat4 mvp;
+};
+
+void main()
+{
+	gl_Position = mvp*vec4(xy, 0.0, 1.0);
+}